@@ -0,0 +1,88 @@
+// Compare the alpha kernels with the scalar loops on a synthetic terrain mask. Exit code is not zero if the results differ.
+// Usage: alpha_kernels_benchmark [iterations]
+#include <SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <utils/sdl/sdl_alpha_kernels.h>
+#include <vector>
+
+namespace
+{
+
+constexpr Uint32 alphaMaskABGR8888 = 0xFF000000; // Same as TerrainMask.
+constexpr int maskWidth = 2048;
+constexpr int maskHeight = 1024;
+constexpr int chunkSize = 32; // Width of the rows checked by TerrainMask::IsEmpty in the collision rebuild.
+
+// Upper half is empty. Lower half is solid with random explosion holes.
+std::vector<Uint32> CreateTerrainMask()
+{
+    std::vector<Uint32> pixels(maskWidth * maskHeight, 0);
+    for (int y = maskHeight / 2; y < maskHeight; ++y)
+        for (int x = 0; x < maskWidth; ++x)
+            pixels[y * maskWidth + x] = 0xFF336699;
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> xDistribution(0, maskWidth - 1);
+    std::uniform_int_distribution<int> yDistribution(maskHeight / 2, maskHeight - 1);
+    std::uniform_int_distribution<int> radiusDistribution(4, 40);
+    for (int hole = 0; hole < 300; ++hole)
+    {
+        int centerX = xDistribution(random);
+        int centerY = yDistribution(random);
+        int radius = radiusDistribution(random);
+        for (int y = std::max(0, centerY - radius); y < std::min(maskHeight, centerY + radius); ++y)
+            for (int x = std::max(0, centerX - radius); x < std::min(maskWidth, centerX + radius); ++x)
+                if ((x - centerX) * (x - centerX) + (y - centerY) * (y - centerY) < radius * radius)
+                    pixels[y * maskWidth + x] = 0;
+    }
+    return pixels;
+}
+
+// Run the row function on all chunk rows of the mask. Return the time in microseconds and the checksum of the results.
+template <typename Function>
+std::pair<long long, long long> Measure(const std::vector<Uint32>& pixels, int iterations, Function function)
+{
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        for (int y = 0; y < maskHeight; ++y)
+            for (int x = 0; x < maskWidth; x += chunkSize)
+                checksum += function(&pixels[y * maskWidth + x], chunkSize, alphaMaskABGR8888);
+    auto finish = std::chrono::steady_clock::now();
+    return {std::chrono::duration_cast<std::chrono::microseconds>(finish - start).count(), checksum};
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20;
+    if (iterations <= 0)
+    {
+        std::fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    auto pixels = CreateTerrainMask();
+    auto [anyScalarUs, anyScalarSum] = Measure(pixels, iterations, utils::scalar::AnyAlpha);
+    auto [anyKernelUs, anyKernelSum] = Measure(pixels, iterations, utils::AnyAlpha);
+    auto [countScalarUs, countScalarSum] = Measure(pixels, iterations, utils::scalar::CountAlpha);
+    auto [countKernelUs, countKernelSum] = Measure(pixels, iterations, utils::CountAlpha);
+
+    std::printf("%s kernels, mask %dx%d, rows of %d pixels, %d iterations\n", utils::GetAlphaKernelsName(), maskWidth, maskHeight, chunkSize, iterations);
+    std::printf("AnyAlpha:   scalar %lld us, kernels %lld us\n", anyScalarUs, anyKernelUs);
+    std::printf("CountAlpha: scalar %lld us, kernels %lld us\n", countScalarUs, countKernelUs);
+
+    if (anyScalarSum != anyKernelSum || countScalarSum != countKernelSum)
+    {
+        std::fprintf(stderr, "Results of the kernels differ from the scalar loops\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+// Compare the terrain contour extraction on the calling thread with the extraction on the task scheduler workers.
+// All chunks of a synthetic terrain mask are extracted, as after a heavy destruction. Exit code is not zero if the
+// results differ.
+// Usage: terrain_contours_benchmark [iterations] [workers]
+#include <SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <utility>
+#include <utils/task_scheduler.h>
+#include <utils/terrain/terrain_contours.h>
+#include <utils/terrain/terrain_mask.h>
+#include <vector>
+
+namespace
+{
+
+constexpr int maskWidth = 2048;
+constexpr int maskHeight = 1024;
+constexpr int chunkSize = 64; // Same as TerrainSystem.chunkSize.
+constexpr int cellSize = 4; // Same as TerrainSystem.collisionCellSize.
+
+// Upper half is empty. Lower half is solid with random explosion holes.
+TerrainMask CreateTerrainMask()
+{
+    TerrainMask mask(maskWidth, maskHeight);
+    for (int y = maskHeight / 2; y < maskHeight; ++y)
+        for (int x = 0; x < maskWidth; ++x)
+            mask.SetPixel(x, y, 0xFF336699);
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> xDistribution(0, maskWidth - 1);
+    std::uniform_int_distribution<int> yDistribution(maskHeight / 2, maskHeight - 1);
+    std::uniform_int_distribution<int> radiusDistribution(4, 40);
+    for (int hole = 0; hole < 300; ++hole)
+        mask.CarveCircle(glm::vec2(xDistribution(random), yDistribution(random)), static_cast<float>(radiusDistribution(random)));
+    return mask;
+}
+
+// Extract contours of all chunks. Return the time in microseconds and the number of the contour points.
+std::pair<long long, size_t> Measure(const TerrainMask& mask, int iterations, TaskScheduler& taskScheduler)
+{
+    int chunkCols = (maskWidth + chunkSize - 1) / chunkSize;
+    int chunkRows = (maskHeight + chunkSize - 1) / chunkSize;
+    std::vector<std::vector<TerrainContour>> contoursByChunk(chunkCols * chunkRows);
+
+    size_t pointsCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        taskScheduler.ParallelFor(
+            contoursByChunk.size(),
+            [&](size_t chunkIndex)
+            {
+                int chunkCol = static_cast<int>(chunkIndex) % chunkCols;
+                int chunkRow = static_cast<int>(chunkIndex) / chunkCols;
+                SDL_Rect chunkRect{chunkCol * chunkSize, chunkRow * chunkSize, chunkSize, chunkSize};
+                contoursByChunk[chunkIndex] = utils::ExtractChunkContours(mask, chunkRect, cellSize);
+            });
+
+        for (const auto& contours : contoursByChunk)
+            for (const auto& contour : contours)
+                pointsCount += contour.points.size();
+    }
+    auto finish = std::chrono::steady_clock::now();
+    return {std::chrono::duration_cast<std::chrono::microseconds>(finish - start).count(), pointsCount};
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20;
+    // The calling thread takes part in the work, so one core is left for it by default.
+    int workers = argc > 2 ? std::atoi(argv[2]) : std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    if (iterations <= 0 || workers < 0)
+    {
+        std::fprintf(stderr, "Usage: %s [iterations] [workers]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    auto mask = CreateTerrainMask();
+    TaskScheduler singleThreaded(0);
+    TaskScheduler multiThreaded(workers);
+    auto [singleUs, singlePoints] = Measure(mask, iterations, singleThreaded);
+    auto [multiUs, multiPoints] = Measure(mask, iterations, multiThreaded);
+
+    std::printf("Mask %dx%d, chunks of %d pixels, cells of %d pixels, %d iterations\n", maskWidth, maskHeight, chunkSize, cellSize, iterations);
+    std::printf("0 workers: %lld us\n", singleUs);
+    std::printf("%d workers: %lld us\n", workers, multiUs);
+
+    if (singlePoints != multiPoints)
+    {
+        std::fprintf(stderr, "Contours extracted by the workers differ from the single-threaded ones\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1,13 +1,33 @@
 #pragma once
-#include <memory>
-#include <utils/box2d/box2d_RAII.h>
+#include <box2d/box2d.h>
+#include <glm/glm.hpp>
+#include <type_traits>
 #include <utils/box2d/box2d_body_options.h>
 
+// Trivially copyable. The body is owned by the registry, see utils::ConnectBox2dBodyOwnership.
 struct PhysicsComponent
 {
-    std::shared_ptr<Box2dObjectRAII> bodyRAII; // Used also for the rendering to retrieve angle and position.
+    b2Body* body = nullptr; // Used also for the rendering to retrieve angle and position.
     Box2dBodyOptions options;
 };
+static_assert(std::is_trivially_copyable_v<PhysicsComponent>);
+
+// Transform of the body cached by PhysicsSystem after each physics step. Attached together with PhysicsComponent.
+// Systems read it from the contiguous storage instead of the scattered Box2D bodies.
+// Must be updated with Box2dBodyTuner::UpdateTransformComponent when the body is moved outside of the physics step.
+struct TransformComponent
+{
+    b2Vec2 positionPhysics{0.0f, 0.0f};
+    float angle = 0.0f;
+    glm::vec2 positionWorld{0.0f, 0.0f};
+    b2Vec2 previousPositionPhysics{0.0f, 0.0f}; // Position before the last fixed physics step. Used for the render interpolation.
+    float previousAngle = 0.0f; // Angle before the last fixed physics step. Used for the render interpolation.
+};
+
+// Attached while the body is not static. Maintained by Box2dBodyTuner. PhysicsSystem updates only these bodies after
+// the step, so its cost doesn't depend on the number of static tiles.
+struct DynamicBodyComponent
+{};
 
 struct HitCountComponent
 {
@@ -21,11 +41,26 @@ struct StickyComponent
 };
 
 struct ExplostionParticlesComponent
-{};
+{
+    float asleepSeconds = 0.0f; // How long the body is asleep. Settled particles are merged back to the terrain.
+    size_t spawnOrder = 0; // Older particles are evicted first when the budget of particles is exceeded.
+};
 
 struct PixeledTileComponent
 {};
 
+/////// One of the angle policy tags is attached together with PhysicsComponent. See Box2dBodyOptions::AnglePolicy. ///
+/////////////// Maintained by Box2dBodyTuner. Only VelocityDirection bodies are updated on each step. ////////////////
+
+struct FixedAngleComponent
+{};
+
+struct DynamicAngleComponent
+{};
+
+struct VelocityDirectionAngleComponent
+{};
+
 ///// Pair DestructibleComponent and IndestructibleComponent to make the entity destructible or indestructible. ///
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -6,6 +6,7 @@
 #include <memory>
 #include <utils/sdl/sdl_RAII.h>
 #include <utils/sdl/sdl_colors.h>
+#include <vector>
 
 enum class ZOrderingType
 {
@@ -40,6 +41,22 @@ struct TileComponent
     ColorName colorName = ColorName::Blue; // Color if the texture is not available.
 };
 
+// Tile without physics and without own entity. Stored in TileLayerComponent.
+struct LayerTile
+{
+    glm::vec2 centerWorld = {0, 0};
+    SDL_Rect textureRect{}; // Rectangle in the texture of the layer.
+};
+
+// Flat render-only array of tiles sharing the same texture and size. One entity per loaded layer.
+struct TileLayerComponent
+{
+    std::shared_ptr<SDLTextureRAII> texturePtr{}; // Pointer to the texture.
+    glm::vec2 tileSizeWorld = {0, 0};
+    ZOrderingType zOrderingType = ZOrderingType::Terrain;
+    std::vector<LayerTile> tiles;
+};
+
 struct DebugVisualObjectComponent
 {};
 
@@ -0,0 +1,30 @@
+#pragma once
+#include <SDL.h>
+#include <box2d/box2d.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <utils/sdl/sdl_RAII.h>
+#include <utils/terrain/terrain_mask.h>
+#include <vector>
+
+// Destructible terrain layer stored as a bitmap. One entity per layer instead of one entity per mini tile.
+// Entity also has PhysicsComponent (static body with chain fixtures built from the mask) and TileComponent (rendering).
+struct TerrainComponent
+{
+    TerrainMask mask; // Pixels of the terrain. Pixel is solid if its alpha is not zero.
+    std::shared_ptr<SDLTextureRAII> texture; // Streaming texture with the content of the mask.
+    glm::vec2 originWorld{0, 0}; // World position of the top left corner of the mask.
+    SDL_Rect dirtyRect{0, 0, 0, 0}; // Rect of the mask changed since the last update of the texture and the collision.
+public: ///////////////////////// Collision. Fixtures are grouped by chunks to rebuild only changed chunks. ///////////////////////
+    int chunkSize = 0; // Size of the chunk in pixels. Set on the first collision build.
+    int chunkCols = 0;
+    std::vector<std::vector<b2Fixture*>> chunkFixtures; // Row-major. Fixtures are owned by the body of the entity.
+public: ///////////////////////////// Source tiles. Used to texture and to settle the debris. ////////////////////////////
+    std::shared_ptr<SDLTextureRAII> tilesetTexture;
+    std::shared_ptr<SDLSurfaceRAII> tilesetSurface; // Pixels of the tileset. Used to stamp the settled debris back to the mask.
+    std::vector<SDL_Rect> tileTextureRects; // Rect in the tileset for every tile of the layer. Empty rect for empty tiles.
+    int layerCols = 0;
+    int tileWidth = 0;
+    int tileHeight = 0;
+    int debrisCellSize = 0; // Size of the debris spawned on explosion. Must divide the tile size.
+};
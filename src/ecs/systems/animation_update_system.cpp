@@ -52,7 +52,7 @@ void AnimationUpdateSystem::UpdatePlayerAnimationDirectionAndSpeed()
         const auto& [animationInfo, playerInfo, physicsInfo] = view.get<AnimationComponent, PlayerComponent, PhysicsComponent>(entity);
 
         // Change the animation speed based on the player's speed.
-        auto body = physicsInfo.bodyRAII->GetBody();
+        auto body = physicsInfo.body;
         auto vel = body->GetLinearVelocity();
         float speed = glm::length(glm::vec2(vel.x, vel.y));
 
@@ -3,6 +3,7 @@
 #include <ecs/components/physics_components.h>
 #include <ecs/components/player_components.h>
 #include <my_cpp_utils/config.h>
+#include <utils/box2d/box2d_interpolation.h>
 #include <utils/coordinates_transformer.h>
 #include <utils/game_options.h>
 
@@ -81,13 +82,11 @@ void CameraControlSystem::PositioningCameraToPlayer(float deltaTime)
     auto& cameraCenterPosWorld = gameState.windowOptions.cameraCenterSdl;
     glm::vec2 windowSize = coordinatesTransformer.ScreenToWorld(gameState.windowOptions.windowSize, CoordinatesTransformer::Type::Length);
 
-    auto players = registry.view<PlayerComponent, PhysicsComponent>();
+    auto players = registry.view<PlayerComponent, TransformComponent>();
     for (auto entity : players)
     {
-        const auto& physicsInfo = players.get<PhysicsComponent>(entity);
-        auto playerBody = physicsInfo.bodyRAII->GetBody();
-
-        auto playerPosWorld = coordinatesTransformer.PhysicsToWorld(playerBody->GetPosition());
+        const auto& transform = players.get<TransformComponent>(entity);
+        auto playerPosWorld = coordinatesTransformer.PhysicsToWorld(utils::GetInterpolatedPosition(transform, gameState.physicsOptions.interpolationAlpha));
 
         glm::vec2 cameraAnchorPosWorld = playerPosWorld;
 
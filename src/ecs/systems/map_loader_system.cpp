@@ -2,7 +2,13 @@
 #include "utils/factories/base_objects_factory.h"
 #include <SDL_image.h>
 #include <box2d/b2_math.h>
+#include <chrono>
 #include <ecs/components/physics_components.h>
+#include <ecs/components/player_components.h>
+#include <ecs/components/portal_components.h>
+#include <ecs/components/rendering_components.h>
+#include <ecs/components/terrain_components.h>
+#include <ecs/components/turret_component.h>
 #include <fstream>
 #include <my_cpp_utils/config.h>
 #include <my_cpp_utils/math_utils.h>
@@ -12,6 +18,9 @@
 #include <utils/logger.h>
 #include <utils/math_utils.h>
 #include <utils/sdl/sdl_texture_process.h>
+#include <utils/sdl/sdl_utils.h>
+#include <utility>
+#include <variant>
 
 MapLoaderSystem::MapLoaderSystem(
     EnttRegistryWrapper& registryWrapper, ResourceManager& resourceManager, Box2dEnttContactListener& contactListener, GameObjectsFactory& gameObjectsFactory,
@@ -23,9 +32,97 @@ MapLoaderSystem::MapLoaderSystem(
 
 void MapLoaderSystem::LoadMap(const LevelInfo& levelInfo)
 {
+    LoadMap(levelInfo, utils::GetConfig<BakedLevelsPolicy, "MapLoaderSystem.bakedLevelsPolicy">());
+}
+
+void MapLoaderSystem::CheckLevelBakeRoundTrip(const LevelInfo& levelInfo)
+{
+    // The first load parses the map file even if the level is baked already.
+    bakedLevels.erase(levelInfo.tiledMapPath.string());
+    LoadMap(levelInfo, BakedLevelsPolicy::Cache);
+    auto parsedLevel = SummarizeLoadedLevel();
+
+    if (!LoadMap(levelInfo, BakedLevelsPolicy::Cache))
+        throw std::runtime_error(MY_FMT("[MapLoaderSystem] Level {} is not restored from the baked level", levelInfo.name));
+    auto restoredLevel = SummarizeLoadedLevel();
+
+    if (!(parsedLevel == restoredLevel))
+    {
+        throw std::runtime_error(MY_FMT(
+            "[MapLoaderSystem] Level {} restored from the baked level differs from the parsed one. Parsed: {}. Restored: {}", levelInfo.name,
+            parsedLevel.ToString(), restoredLevel.ToString()));
+    }
+
+    MY_LOG(info, "Level {} restored from the baked level is the same as the parsed one: {}", levelInfo.name, restoredLevel.ToString());
+}
+
+bool MapLoaderSystem::LoadMap(const LevelInfo& levelInfo, BakedLevelsPolicy bakedLevelsPolicy)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
     RecreateBox2dWorld();
 
+    // Load background texture.
+    gameState.levelOptions.backgroundInfo.texture = resourceManager.GetTexture(levelInfo.backgroundPath);
+
+    // Parse the map file if the level is not baked yet. Without the cache the level is parsed on each load.
+    std::string levelKey = levelInfo.tiledMapPath.string();
+    auto it = bakedLevels.find(levelKey);
+    bool isRestoredFromCache = bakedLevelsPolicy == BakedLevelsPolicy::Cache && it != bakedLevels.end();
+    if (!isRestoredFromCache)
+        it = bakedLevels.insert_or_assign(levelKey, BakeLevel(levelInfo)).first;
+
+    const LevelSnapshot& levelSnapshot = it->second;
+    RestoreLevel(levelSnapshot);
+
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+    MY_LOG(
+        info, "Map {} loaded in {:.3f} ms ({}, {} steps)", levelInfo.name, duration.count(), isRestoredFromCache ? "restored from the baked level" : "parsed",
+        levelSnapshot.steps.size());
+    return isRestoredFromCache;
+}
+
+MapLoaderSystem::LoadedLevelSummary MapLoaderSystem::SummarizeLoadedLevel()
+{
+    LoadedLevelSummary summary{};
+    summary.bodiesCount = gameState.physicsWorld->GetBodyCount();
+    for (b2Body* body = gameState.physicsWorld->GetBodyList(); body; body = body->GetNext())
+        for (b2Fixture* fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext())
+            summary.fixturesCount++;
+
+    summary.physicsEntitiesCount = registry.view<PhysicsComponent>().size();
+    summary.tilesCount = registry.view<TileComponent>().size();
+    summary.tileLayersCount = registry.view<TileLayerComponent>().size();
+    summary.terrainsCount = registry.view<TerrainComponent>().size();
+    summary.playersCount = registry.view<PlayerComponent>().size();
+    summary.portalsCount = registry.view<PortalComponent>().size();
+    summary.turretsCount = registry.view<TurretComponent>().size();
+    summary.levelBox2dBounds = gameState.levelOptions.levelBox2dBounds;
+    return summary;
+}
+
+bool MapLoaderSystem::LoadedLevelSummary::operator==(const LoadedLevelSummary& other) const
+{
+    return bodiesCount == other.bodiesCount && fixturesCount == other.fixturesCount && physicsEntitiesCount == other.physicsEntitiesCount &&
+        tilesCount == other.tilesCount && tileLayersCount == other.tileLayersCount && terrainsCount == other.terrainsCount &&
+        playersCount == other.playersCount && portalsCount == other.portalsCount && turretsCount == other.turretsCount &&
+        levelBox2dBounds.min == other.levelBox2dBounds.min && levelBox2dBounds.max == other.levelBox2dBounds.max;
+}
+
+std::string MapLoaderSystem::LoadedLevelSummary::ToString() const
+{
+    return MY_FMT(
+        "bodies={}, fixtures={}, physicsEntities={}, tiles={}, tileLayers={}, terrains={}, players={}, portals={}, turrets={}, bounds={}..{}", bodiesCount,
+        fixturesCount, physicsEntitiesCount, tilesCount, tileLayersCount, terrainsCount, playersCount, portalsCount, turretsCount, levelBox2dBounds.min,
+        levelBox2dBounds.max);
+}
+
+LevelSnapshot MapLoaderSystem::BakeLevel(const LevelInfo& levelInfo)
+{
     currentLevelInfo = levelInfo;
+    bakingLevel = {};
+    createdTiles = 0;
+    invisibleTilesNumber = 0;
 
     // Save map file path and load it as json.
     std::ifstream file(levelInfo.tiledMapPath);
@@ -39,9 +136,7 @@ void MapLoaderSystem::LoadMap(const LevelInfo& levelInfo)
     std::filesystem::path tilesetPath = ReadPathToTileset(mapJson);
     tilesetTexture = resourceManager.GetTexture(tilesetPath);
     tilesetSurface = resourceManager.GetSurface(tilesetPath);
-
-    // Load background texture.
-    gameState.levelOptions.backgroundInfo.texture = resourceManager.GetTexture(levelInfo.backgroundPath);
+    tilesetAlphaTable = resourceManager.GetSurfaceAlphaTable(tilesetPath);
 
     // Assume all tiles are of the same size.
     tileWidth = mapJson["tilewidth"];
@@ -57,14 +152,36 @@ void MapLoaderSystem::LoadMap(const LevelInfo& levelInfo)
     {
         if (layer["type"] == "tilelayer")
         {
+            bool renderOnlyTransparentLayers =
+                utils::GetConfig<TransparentLayersPolicy, "MapLoaderSystem.transparentLayersPolicy">() == TransparentLayersPolicy::RenderOnly;
             if (layer["name"] == "background")
-                ParseTileLayer(layer, {SpawnTileOption::CollidableOption::Transparent, SpawnTileOption::DesctructibleOption::Indestructible, ZOrderingType::Background});
+            {
+                if (renderOnlyTransparentLayers)
+                    ParseRenderOnlyLayer(layer, ZOrderingType::Background);
+                else
+                    ParseTileLayer(layer, {SpawnTileOption::CollidableOption::Transparent, SpawnTileOption::DesctructibleOption::Indestructible, ZOrderingType::Background});
+            }
             if (layer["name"] == "interiors")
-                ParseTileLayer(layer, {SpawnTileOption::CollidableOption::Transparent, SpawnTileOption::DesctructibleOption::Indestructible, ZOrderingType::Interiors});
+            {
+                if (renderOnlyTransparentLayers)
+                    ParseRenderOnlyLayer(layer, ZOrderingType::Interiors);
+                else
+                    ParseTileLayer(layer, {SpawnTileOption::CollidableOption::Transparent, SpawnTileOption::DesctructibleOption::Indestructible, ZOrderingType::Interiors});
+            }
             if (layer["name"] == "terrain")
-                ParseTileLayer(layer, {SpawnTileOption::CollidableOption::Collidable, SpawnTileOption::DesctructibleOption::Destructible, ZOrderingType::Terrain});
+            {
+                if (utils::GetConfig<DestructibleLayerPolicy, "MapLoaderSystem.destructibleLayerPolicy">() == DestructibleLayerPolicy::Bitmap)
+                    ParseTerrainLayer(layer);
+                else
+                    ParseTileLayer(layer, {SpawnTileOption::CollidableOption::Collidable, SpawnTileOption::DesctructibleOption::Destructible, ZOrderingType::Terrain});
+            }
             if (layer["name"] == "terrain_no_destructible")
-                ParseTileLayer(layer, {SpawnTileOption::CollidableOption::Collidable, SpawnTileOption::DesctructibleOption::Indestructible, ZOrderingType::Terrain});
+            {
+                if (utils::GetConfig<IndestructibleLayerPolicy, "MapLoaderSystem.indestructibleLayerPolicy">() == IndestructibleLayerPolicy::MergedColliders)
+                    ParseIndestructibleLayer(layer);
+                else
+                    ParseTileLayer(layer, {SpawnTileOption::CollidableOption::Collidable, SpawnTileOption::DesctructibleOption::Indestructible, ZOrderingType::Terrain});
+            }
         }
         else if (layer["type"] == "objectgroup")
         {
@@ -83,6 +200,56 @@ void MapLoaderSystem::LoadMap(const LevelInfo& levelInfo)
         if (invisibleTilesNumber > 0)
             MY_LOG(warn, "All tiles are invisible");
     }
+
+    bakingLevel.levelBox2dBounds = gameState.levelOptions.levelBox2dBounds;
+    return std::exchange(bakingLevel, {});
+}
+
+void MapLoaderSystem::RestoreLevel(const LevelSnapshot& levelSnapshot)
+{
+    gameState.levelOptions.levelBox2dBounds = levelSnapshot.levelBox2dBounds;
+
+    for (const auto& step : levelSnapshot.steps)
+        std::visit([this](const auto& typedStep) { RestoreStep(typedStep); }, step);
+}
+
+void MapLoaderSystem::RestoreStep(const LevelSnapshot::TileBatch& tileBatch)
+{
+    baseObjectsFactory.SpawnTiles(tileBatch.tiles, tileBatch.tileOptions);
+}
+
+void MapLoaderSystem::RestoreStep(const LevelSnapshot::TileLayer& tileLayer)
+{
+    baseObjectsFactory.SpawnTileLayer(tileLayer.tileLayer, tileLayer.name);
+}
+
+void MapLoaderSystem::RestoreStep(const LevelSnapshot::StaticCollider& staticCollider)
+{
+    baseObjectsFactory.SpawnStaticCollider(staticCollider.boxesWorld, staticCollider.name);
+}
+
+void MapLoaderSystem::RestoreStep(const LevelSnapshot::Terrain& terrain)
+{
+    // Copy the mask. The terrain of the loaded level is carved by the explosions.
+    TerrainComponent terrainComponent = terrain.terrain;
+    terrainComponent.texture = resourceManager.CreateStreamingTexture(terrainComponent.mask.GetWidth(), terrainComponent.mask.GetHeight());
+    baseObjectsFactory.SpawnTerrain(std::move(terrainComponent));
+}
+
+void MapLoaderSystem::RestoreStep(const LevelSnapshot::Object& object)
+{
+    switch (object.type)
+    {
+    case LevelSnapshot::Object::Type::Player:
+        gameObjectsFactory.SpawnPlayer(object.posWorld, object.name);
+        break;
+    case LevelSnapshot::Object::Type::Portal:
+        gameObjectsFactory.SpawnPortal(object.posWorld, object.name);
+        break;
+    case LevelSnapshot::Object::Type::Turret:
+        gameObjectsFactory.SpawnTurret(object.posWorld, object.name);
+        break;
+    }
 }
 
 void MapLoaderSystem::ParseTileLayer(const nlohmann::json& layer, SpawnTileOption tileOptions)
@@ -107,6 +274,179 @@ void MapLoaderSystem::ParseTileLayer(const nlohmann::json& layer, SpawnTileOptio
             ParseTile(tileId, layerCol, layerRow, tileOptions);
         }
     }
+
+    bakingLevel.steps.push_back(LevelSnapshot::TileBatch{tileOptions, std::move(tilesToSpawn)});
+    tilesToSpawn.clear();
+}
+
+void MapLoaderSystem::ParseTerrainLayer(const nlohmann::json& layer)
+{
+    if (!tilesetSurface)
+        throw std::runtime_error("tilesetSurface is nullptr");
+
+    int layerCols = layer["width"];
+    int layerRows = layer["height"];
+    const auto& tiles = layer["data"];
+
+    TerrainComponent terrain;
+    terrain.mask = TerrainMask(layerCols * tileWidth, layerRows * tileHeight);
+    terrain.tilesetTexture = tilesetTexture;
+    terrain.tilesetSurface = tilesetSurface;
+    terrain.tileTextureRects.resize(layerCols * layerRows, SDL_Rect{0, 0, 0, 0});
+    terrain.layerCols = layerCols;
+    terrain.tileWidth = tileWidth;
+    terrain.tileHeight = tileHeight;
+    terrain.debrisCellSize = miniWidth;
+
+    // Mini tiles are spawned with the center in the grid nodes. Keep the same placement for the bitmap.
+    terrain.originWorld = glm::vec2(-miniWidth / 2.0f, -miniHeight / 2.0f);
+
+    // Copy pixels of each tile to the mask.
+    for (int layerRow = 0; layerRow < layerRows; ++layerRow)
+    {
+        for (int layerCol = 0; layerCol < layerCols; ++layerCol)
+        {
+            int tileIndex = layerCol + layerRow * layerCols;
+            int tileId = tiles[tileIndex];
+
+            // Skip empty tiles.
+            if (tileId <= 0)
+                continue;
+
+            SDL_Rect textureSrcRect = CalculateSrcRect(tileId, tileWidth, tileHeight, tilesetSurface->get());
+            terrain.tileTextureRects[tileIndex] = textureSrcRect;
+            terrain.mask.CopyFromSurface(tilesetSurface->get(), textureSrcRect, {layerCol * tileWidth, layerRow * tileHeight});
+            createdTiles++;
+        }
+    }
+
+    // Update level bounds.
+    glm::vec2 terrainSizeWorld(terrain.mask.GetWidth(), terrain.mask.GetHeight());
+    b2Vec2 terrainMinPhysics = coordinatesTransformer.WorldToPhysics(terrain.originWorld);
+    b2Vec2 terrainMaxPhysics = coordinatesTransformer.WorldToPhysics(terrain.originWorld + terrainSizeWorld);
+    auto& levelBounds = gameState.levelOptions.levelBox2dBounds;
+    levelBounds.min = utils::Vec2Min(levelBounds.min, terrainMinPhysics);
+    levelBounds.max = utils::Vec2Max(levelBounds.max, terrainMaxPhysics);
+
+    bakingLevel.steps.push_back(LevelSnapshot::Terrain{std::move(terrain)});
+}
+
+void MapLoaderSystem::ParseRenderOnlyLayer(const nlohmann::json& layer, ZOrderingType zOrderingType)
+{
+    std::vector<bool> visibleMiniTiles;
+    TileLayerComponent tileLayer = CollectLayerTiles(layer, zOrderingType, visibleMiniTiles);
+
+    if (!tileLayer.tiles.empty())
+        bakingLevel.steps.push_back(LevelSnapshot::TileLayer{std::move(tileLayer), MY_FMT("TileLayer {}", layer["name"].get<std::string>())});
+}
+
+void MapLoaderSystem::ParseIndestructibleLayer(const nlohmann::json& layer)
+{
+    std::vector<bool> solidCells;
+    TileLayerComponent tileLayer = CollectLayerTiles(layer, ZOrderingType::Terrain, solidCells);
+    int gridCols = static_cast<int>(layer["width"]) * colAndRowNumber;
+    int gridRows = static_cast<int>(layer["height"]) * colAndRowNumber;
+
+    if (!tileLayer.tiles.empty())
+        bakingLevel.steps.push_back(LevelSnapshot::TileLayer{std::move(tileLayer), "IndestructibleTileLayer"});
+
+    // Merge solid mini tiles to rectangles inside each chunk. One static body per chunk.
+    auto& chunkSizePixels = utils::GetConfig<int, "MapLoaderSystem.mergedCollidersChunkSize">();
+    int chunkCells = std::max(1, chunkSizePixels / miniWidth);
+    size_t fixturesNumber = 0;
+    for (int chunkRow = 0; chunkRow < gridRows; chunkRow += chunkCells)
+    {
+        for (int chunkCol = 0; chunkCol < gridCols; chunkCol += chunkCells)
+        {
+            int chunkCols = std::min(chunkCells, gridCols - chunkCol);
+            int chunkRows = std::min(chunkCells, gridRows - chunkRow);
+            std::vector<bool> chunkSolidCells(chunkCols * chunkRows);
+            for (int row = 0; row < chunkRows; ++row)
+                for (int col = 0; col < chunkCols; ++col)
+                    chunkSolidCells[row * chunkCols + col] = solidCells[(chunkRow + row) * gridCols + chunkCol + col];
+
+            auto cellRects = utils::MergeCellsToRects(chunkSolidCells, chunkCols, chunkRows);
+            if (cellRects.empty())
+                continue;
+
+            // Cell (col, row) is centered in (col * miniWidth, row * miniHeight).
+            std::vector<SDL_FRect> boxesWorld;
+            for (const auto& cellRect : cellRects)
+            {
+                boxesWorld.push_back(
+                    {(chunkCol + cellRect.x) * miniWidth - miniWidth / 2.0f, (chunkRow + cellRect.y) * miniHeight - miniHeight / 2.0f,
+                     static_cast<float>(cellRect.w * miniWidth), static_cast<float>(cellRect.h * miniHeight)});
+            }
+
+            fixturesNumber += boxesWorld.size();
+            bakingLevel.steps.push_back(LevelSnapshot::StaticCollider{std::move(boxesWorld), "IndestructibleCollider"});
+        }
+    }
+
+    MY_LOG(debug, "Indestructible layer merged to {} fixtures", fixturesNumber);
+}
+
+TileLayerComponent MapLoaderSystem::CollectLayerTiles(const nlohmann::json& layer, ZOrderingType zOrderingType, std::vector<bool>& visibleMiniTiles)
+{
+    if (!tilesetAlphaTable)
+        throw std::runtime_error("tilesetAlphaTable is nullptr");
+
+    int layerCols = layer["width"];
+    int layerRows = layer["height"];
+    const auto& tiles = layer["data"];
+
+    // Grid of mini tiles of the whole layer.
+    int gridCols = layerCols * colAndRowNumber;
+    int gridRows = layerRows * colAndRowNumber;
+    visibleMiniTiles.assign(gridCols * gridRows, false);
+
+    TileLayerComponent tileLayer{tilesetTexture, glm::vec2(miniWidth, miniHeight), zOrderingType, {}};
+
+    for (int layerRow = 0; layerRow < layerRows; ++layerRow)
+    {
+        for (int layerCol = 0; layerCol < layerCols; ++layerCol)
+        {
+            int tileId = tiles[layerCol + layerRow * layerCols];
+
+            // Skip empty tiles.
+            if (tileId <= 0)
+                continue;
+
+            SDL_Rect textureSrcRect = CalculateSrcRect(tileId, tileWidth, tileHeight, tilesetSurface->get());
+            for (int miniRow = 0; miniRow < colAndRowNumber; ++miniRow)
+            {
+                for (int miniCol = 0; miniCol < colAndRowNumber; ++miniCol)
+                {
+                    SDL_Rect miniTextureSrcRect{textureSrcRect.x + miniCol * miniWidth, textureSrcRect.y + miniRow * miniHeight, miniWidth, miniHeight};
+
+                    // Skip invisible tiles.
+                    if (tilesetAlphaTable->IsInvisible(miniTextureSrcRect))
+                    {
+                        invisibleTilesNumber++;
+                        continue;
+                    }
+
+                    int gridCol = layerCol * colAndRowNumber + miniCol;
+                    int gridRow = layerRow * colAndRowNumber + miniRow;
+                    visibleMiniTiles[gridRow * gridCols + gridCol] = true;
+
+                    // Mini tiles have the same placement as the bodies spawned by ParseTile.
+                    glm::vec2 miniTileWorldPosition(gridCol * miniWidth, gridRow * miniHeight);
+                    tileLayer.tiles.push_back({miniTileWorldPosition, miniTextureSrcRect});
+
+                    // Update level bounds.
+                    b2Vec2 miniTilePhysicsPosition = coordinatesTransformer.WorldToPhysics(miniTileWorldPosition);
+                    auto& levelBounds = gameState.levelOptions.levelBox2dBounds;
+                    levelBounds.min = utils::Vec2Min(levelBounds.min, miniTilePhysicsPosition);
+                    levelBounds.max = utils::Vec2Max(levelBounds.max, miniTilePhysicsPosition);
+
+                    createdTiles++;
+                }
+            }
+        }
+    }
+
+    return tileLayer;
 }
 
 void MapLoaderSystem::ParseObjectLayer(const nlohmann::json& layer)
@@ -117,21 +457,21 @@ void MapLoaderSystem::ParseObjectLayer(const nlohmann::json& layer)
         {
             std::string objectName = object["name"];
             auto posWorld = glm::vec2(object["x"], object["y"]);
-            gameObjectsFactory.SpawnPlayer(posWorld, objectName);
+            bakingLevel.steps.push_back(LevelSnapshot::Object{LevelSnapshot::Object::Type::Player, objectName, posWorld});
         }
 
         if (object["type"] == "Portal")
         {
             std::string objectName = object["name"];
             auto posWorld = glm::vec2(object["x"], object["y"]);
-            gameObjectsFactory.SpawnPortal(posWorld, objectName);
+            bakingLevel.steps.push_back(LevelSnapshot::Object{LevelSnapshot::Object::Type::Portal, objectName, posWorld});
         }
 
         if (object["type"] == "Turret")
         {
             std::string objectName = object["name"];
             auto posWorld = glm::vec2(object["x"], object["y"]);
-            gameObjectsFactory.SpawnTurret(posWorld, objectName);
+            bakingLevel.steps.push_back(LevelSnapshot::Object{LevelSnapshot::Object::Type::Turret, objectName, posWorld});
         }
     }
 }
@@ -150,9 +490,27 @@ void MapLoaderSystem::ParseTile(int tileId, int layerCol, int layerRow, SpawnTil
 {
     auto physicsWorld = gameState.physicsWorld;
 
-    SDL_Rect textureSrcRect = CalculateSrcRect(tileId, tileWidth, tileHeight, tilesetTexture);
+    SDL_Rect textureSrcRect = CalculateSrcRect(tileId, tileWidth, tileHeight, tilesetSurface->get());
+
+    if (utils::GetConfig<TileSubdivisionPolicy, "MapLoaderSystem.tileSubdivisionPolicy">() == TileSubdivisionPolicy::Adaptive)
+    {
+        if (!tilesetAlphaTable)
+            throw std::runtime_error("tilesetAlphaTable is nullptr");
+
+        // Mini tiles are used only to find the transparent parts of the tile. The tile is spawned with the biggest nodes.
+        std::vector<bool> visibleMiniTiles(colAndRowNumber * colAndRowNumber);
+        for (int miniRow = 0; miniRow < colAndRowNumber; ++miniRow)
+        {
+            for (int miniCol = 0; miniCol < colAndRowNumber; ++miniCol)
+            {
+                SDL_Rect miniTextureSrcRect{textureSrcRect.x + miniCol * miniWidth, textureSrcRect.y + miniRow * miniHeight, miniWidth, miniHeight};
+                visibleMiniTiles[miniRow * colAndRowNumber + miniCol] = !tilesetAlphaTable->IsInvisible(miniTextureSrcRect);
+            }
+        }
 
-    Box2dBodyCreator box2dBodyCreator(registry);
+        ParseTileNode(textureSrcRect, visibleMiniTiles, layerCol, layerRow, {0, 0, colAndRowNumber, colAndRowNumber}, tileOptions);
+        return;
+    }
 
     // Create entities for each mini tile inside the tile.
     for (int miniRow = 0; miniRow < colAndRowNumber; ++miniRow)
@@ -163,10 +521,10 @@ void MapLoaderSystem::ParseTile(int tileId, int layerCol, int layerRow, SpawnTil
 
             // Skip invisible tiles.
             {
-                if (!tilesetSurface)
-                    throw std::runtime_error("tilesetSurface is nullptr");
+                if (!tilesetAlphaTable)
+                    throw std::runtime_error("tilesetAlphaTable is nullptr");
 
-                if (IsTileInvisible(tilesetSurface->get(), miniTextureSrcRect))
+                if (tilesetAlphaTable->IsInvisible(miniTextureSrcRect))
                 {
                     invisibleTilesNumber++;
                     continue;
@@ -178,11 +536,10 @@ void MapLoaderSystem::ParseTile(int tileId, int layerCol, int layerRow, SpawnTil
             float miniTileWorldPositionY = layerRow * tileHeight + miniRow * miniHeight;
             glm::vec2 miniTileWorldPosition{miniTileWorldPositionX, miniTileWorldPositionY};
             auto textureRect = TextureRect{tilesetTexture, miniTextureSrcRect};
-            auto tileEntity = baseObjectsFactory.SpawnTile(miniTileWorldPosition, miniWidth, textureRect, tileOptions);
+            tilesToSpawn.push_back({miniTileWorldPosition, static_cast<float>(miniWidth), textureRect});
 
             // Update level bounds.
-            auto bodyRAII = registry.get<PhysicsComponent>(tileEntity).bodyRAII;
-            const b2Vec2& bodyPosition = bodyRAII->GetBody()->GetPosition();
+            b2Vec2 bodyPosition = coordinatesTransformer.WorldToPhysics(miniTileWorldPosition);
             auto& levelBounds = gameState.levelOptions.levelBox2dBounds;
             levelBounds.min = utils::Vec2Min(levelBounds.min, bodyPosition);
             levelBounds.max = utils::Vec2Max(levelBounds.max, bodyPosition);
@@ -192,6 +549,61 @@ void MapLoaderSystem::ParseTile(int tileId, int layerCol, int layerRow, SpawnTil
     }
 }
 
+void MapLoaderSystem::ParseTileNode(
+    const SDL_Rect& textureSrcRect, const std::vector<bool>& visibleMiniTiles, int layerCol, int layerRow, const SDL_Rect& nodeMiniRect,
+    SpawnTileOption tileOptions)
+{
+    int visibleNumber = 0;
+    for (int miniRow = nodeMiniRect.y; miniRow < nodeMiniRect.y + nodeMiniRect.h; ++miniRow)
+        for (int miniCol = nodeMiniRect.x; miniCol < nodeMiniRect.x + nodeMiniRect.w; ++miniCol)
+            visibleNumber += visibleMiniTiles[miniRow * colAndRowNumber + miniCol];
+
+    if (visibleNumber == 0)
+    {
+        invisibleTilesNumber += nodeMiniRect.w * nodeMiniRect.h;
+        return;
+    }
+
+    // Partially transparent node. Subdivide it to the quadrants. Odd nodes are subdivided to the mini tiles.
+    if (visibleNumber < nodeMiniRect.w * nodeMiniRect.h)
+    {
+        if (nodeMiniRect.w % 2 == 0)
+        {
+            int half = nodeMiniRect.w / 2;
+            for (int quadRow = 0; quadRow < 2; ++quadRow)
+                for (int quadCol = 0; quadCol < 2; ++quadCol)
+                    ParseTileNode(
+                        textureSrcRect, visibleMiniTiles, layerCol, layerRow, {nodeMiniRect.x + quadCol * half, nodeMiniRect.y + quadRow * half, half, half},
+                        tileOptions);
+        }
+        else
+        {
+            for (int miniRow = nodeMiniRect.y; miniRow < nodeMiniRect.y + nodeMiniRect.h; ++miniRow)
+                for (int miniCol = nodeMiniRect.x; miniCol < nodeMiniRect.x + nodeMiniRect.w; ++miniCol)
+                    ParseTileNode(textureSrcRect, visibleMiniTiles, layerCol, layerRow, {miniCol, miniRow, 1, 1}, tileOptions);
+        }
+        return;
+    }
+
+    // Fully visible node. Spawn it as one tile. It is subdivided later by the explosions.
+    SDL_Rect nodeTextureSrcRect{
+        textureSrcRect.x + nodeMiniRect.x * miniWidth, textureSrcRect.y + nodeMiniRect.y * miniHeight, nodeMiniRect.w * miniWidth, nodeMiniRect.h * miniHeight};
+
+    // Mini tile (miniCol, miniRow) is centered in (layerCol * tileWidth + miniCol * miniWidth, ...).
+    glm::vec2 firstMiniTileWorldPosition(layerCol * tileWidth + nodeMiniRect.x * miniWidth, layerRow * tileHeight + nodeMiniRect.y * miniHeight);
+    glm::vec2 lastMiniTileWorldPosition = firstMiniTileWorldPosition + glm::vec2((nodeMiniRect.w - 1) * miniWidth, (nodeMiniRect.h - 1) * miniHeight);
+    glm::vec2 nodeWorldPosition = (firstMiniTileWorldPosition + lastMiniTileWorldPosition) / 2.0f;
+    auto textureRect = TextureRect{tilesetTexture, nodeTextureSrcRect};
+    tilesToSpawn.push_back({nodeWorldPosition, static_cast<float>(nodeTextureSrcRect.w), textureRect});
+
+    // Update level bounds.
+    auto& levelBounds = gameState.levelOptions.levelBox2dBounds;
+    levelBounds.min = utils::Vec2Min(levelBounds.min, coordinatesTransformer.WorldToPhysics(firstMiniTileWorldPosition));
+    levelBounds.max = utils::Vec2Max(levelBounds.max, coordinatesTransformer.WorldToPhysics(lastMiniTileWorldPosition));
+
+    createdTiles++;
+}
+
 std::filesystem::path MapLoaderSystem::ReadPathToTileset(const nlohmann::json& mapJson)
 {
     std::filesystem::path tilesetPath;
@@ -241,13 +653,26 @@ void MapLoaderSystem::RecreateBox2dWorld()
     // Remove all entities except the GameOptions entity.
     for (auto entity : registry.view<PhysicsComponent>())
         registryWrapper.Destroy(entity);
+    for (auto entity : registry.view<TileLayerComponent>())
+        registryWrapper.Destroy(entity);
+
+    // Bodies of the destroyed entities are returned to the pool. The rest of the bodies of the world are leaked.
+    if (gameState.physicsWorld)
+    {
+        size_t pooledBodiesCount = gameState.bodyPool ? gameState.bodyPool->GetPooledBodiesCount() : 0;
+        size_t leakedBodiesCount = static_cast<size_t>(gameState.physicsWorld->GetBodyCount()) - pooledBodiesCount;
+        if (leakedBodiesCount != 0)
+            MY_LOG(warn, "There are still {} Box2D bodies in the memory", leakedBodiesCount);
+        else
+            MY_LOG(debug, "All Box2D bodies were destroyed");
+    }
+
+    if (gameState.bodyPool)
+        gameState.bodyPool->LogStats();
 
-    // Create a physics world with gravity and store it in the registry.
+    // Create a physics world with gravity and store it in the registry. Pooled bodies of the old world are destroyed.
+    gameState.bodyPool.reset();
     gameState.physicsWorld = std::make_shared<b2World>(gameState.gravity);
     gameState.physicsWorld->SetContactListener(&contactListener);
-
-    if (Box2dObjectRAII::GetBodyCounter() != 0)
-        MY_LOG(warn, "There are still {} Box2D bodies in the memory", Box2dObjectRAII::GetBodyCounter());
-    else
-        MY_LOG(debug, "All Box2D bodies were destroyed");
+    gameState.bodyPool = std::make_shared<Box2dBodyPool>(gameState.physicsWorld);
 }
@@ -3,16 +3,77 @@
 #include <entt/entt.hpp>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <string>
+#include <unordered_map>
 #include <utils/coordinates_transformer.h>
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/factories/game_objects_factory.h>
 #include <utils/level_info.h>
+#include <utils/level_snapshot.h>
 #include <utils/resources/resource_manager.h>
 #include <utils/sdl/sdl_RAII.h>
 #include <utils/systems/box2d_entt_contact_listener.h>
 
+// How the destructible `terrain` layer is loaded.
+enum class DestructibleLayerPolicy
+{
+    Bitmap, // Bitmap terrain with one static body. Collision is built from the bitmap by TerrainSystem.
+    Tiles, // One body per tile.
+};
+NLOHMANN_JSON_SERIALIZE_ENUM(DestructibleLayerPolicy, {{DestructibleLayerPolicy::Bitmap, "Bitmap"}, {DestructibleLayerPolicy::Tiles, "Tiles"}})
+
+// How the indestructible `terrain_no_destructible` layer is loaded.
+enum class IndestructibleLayerPolicy
+{
+    MergedColliders, // Render-only tile layer. Collision is merged to rectangles with one static body per chunk.
+    Tiles, // One body per tile.
+};
+NLOHMANN_JSON_SERIALIZE_ENUM(
+    IndestructibleLayerPolicy, {{IndestructibleLayerPolicy::MergedColliders, "MergedColliders"}, {IndestructibleLayerPolicy::Tiles, "Tiles"}})
+
+// How the transparent `background` and `interiors` layers are loaded.
+enum class TransparentLayersPolicy
+{
+    RenderOnly, // Flat render-only tile array. No physics bodies and no entity per tile.
+    Tiles, // One transparent body per tile.
+};
+NLOHMANN_JSON_SERIALIZE_ENUM(TransparentLayersPolicy, {{TransparentLayersPolicy::RenderOnly, "RenderOnly"}, {TransparentLayersPolicy::Tiles, "Tiles"}})
+
+// How the tiles of the physical layers are split.
+enum class TileSubdivisionPolicy
+{
+    Adaptive, // One body per tile. Split as a quadtree only where the tile is transparent or hit by an explosion.
+    MiniTiles, // Split each tile to `tileSplitFactor` x `tileSplitFactor` mini tiles.
+};
+NLOHMANN_JSON_SERIALIZE_ENUM(TileSubdivisionPolicy, {{TileSubdivisionPolicy::Adaptive, "Adaptive"}, {TileSubdivisionPolicy::MiniTiles, "MiniTiles"}})
+
+// How the reloads of the level are loaded.
+enum class BakedLevelsPolicy
+{
+    Cache, // Keep the parsed levels in memory. Reloads restore the level without reading the map file and the tileset.
+    ParseOnEachLoad, // Parse the map file on each load. Used to see the changes of the map file on the reload.
+};
+NLOHMANN_JSON_SERIALIZE_ENUM(BakedLevelsPolicy, {{BakedLevelsPolicy::Cache, "Cache"}, {BakedLevelsPolicy::ParseOnEachLoad, "ParseOnEachLoad"}})
+
 class MapLoaderSystem
 {
+    // Counts of the spawned level parts. Used to compare the parsed level with the restored one.
+    struct LoadedLevelSummary
+    {
+        int bodiesCount;
+        size_t fixturesCount;
+        size_t physicsEntitiesCount;
+        size_t tilesCount;
+        size_t tileLayersCount;
+        size_t terrainsCount;
+        size_t playersCount;
+        size_t portalsCount;
+        size_t turretsCount;
+        LevelPhysicsBounds levelBox2dBounds;
+        bool operator==(const LoadedLevelSummary& other) const;
+        std::string ToString() const;
+    };
+
     EnttRegistryWrapper& registryWrapper;
     entt::registry& registry;
     ResourceManager& resourceManager;
@@ -28,19 +89,52 @@ class MapLoaderSystem
     int miniHeight;
     size_t createdTiles = 0;
     size_t invisibleTilesNumber = 0;
+    std::vector<BaseObjectsFactory::TileSpawn> tilesToSpawn; // Tiles of the current layer. Baked together at the end of the layer.
     std::shared_ptr<SDLTextureRAII> tilesetTexture;
     std::shared_ptr<SDLSurfaceRAII> tilesetSurface; // Optional. Used when Streaming access is needed.
+    std::shared_ptr<SDLAlphaTable> tilesetAlphaTable; // Used to search for invisible tiles.
     LevelInfo currentLevelInfo;
+    LevelSnapshot bakingLevel; // Filled by the Parse* functions.
+    std::unordered_map<std::string, LevelSnapshot> bakedLevels; // Key is the path to the map file.
 public:
     MapLoaderSystem(
         EnttRegistryWrapper& registryWrapper, ResourceManager& resourceManager, Box2dEnttContactListener& contactListener, GameObjectsFactory& gameObjectsFactory,
         BaseObjectsFactory& baseObjectsFactory);
+    // Parse the map on the first load. Restore the baked level on the next loads (see `MapLoaderSystem.bakedLevelsPolicy`).
     void LoadMap(const LevelInfo& levelInfo);
+    // Load the level parsed and then restored from the baked level. Throw if the restored level differs from the parsed one.
+    void CheckLevelBakeRoundTrip(const LevelInfo& levelInfo);
+private:
+    // Return true if the level is restored from the baked level.
+    bool LoadMap(const LevelInfo& levelInfo, BakedLevelsPolicy bakedLevelsPolicy);
+    LoadedLevelSummary SummarizeLoadedLevel();
+    // Read the map file and the tileset. Nothing is spawned, the result is the list of the spawn steps.
+    LevelSnapshot BakeLevel(const LevelInfo& levelInfo);
+    void RestoreLevel(const LevelSnapshot& levelSnapshot);
+private: //////////////////////////////////////// Restore the steps of the snapshot. ////////////////////////////////////////
+    void RestoreStep(const LevelSnapshot::TileBatch& tileBatch);
+    void RestoreStep(const LevelSnapshot::TileLayer& tileLayer);
+    void RestoreStep(const LevelSnapshot::StaticCollider& staticCollider);
+    void RestoreStep(const LevelSnapshot::Terrain& terrain);
+    void RestoreStep(const LevelSnapshot::Object& object);
 private:
     void ParseTileLayer(const nlohmann::json& layer, SpawnTileOption tileOptions);
+    // Build the bitmap terrain from the layer. Used for destructible terrain instead of spawning mini tiles.
+    void ParseTerrainLayer(const nlohmann::json& layer);
+    // Load the layer to the flat render-only array. No physics bodies and no entity per tile.
+    void ParseRenderOnlyLayer(const nlohmann::json& layer, ZOrderingType zOrderingType);
+    // Render tiles of the layer from the flat array. Collision is merged into rectangles with one static body per chunk.
+    void ParseIndestructibleLayer(const nlohmann::json& layer);
+    // Collect visible mini tiles of the layer. `visibleMiniTiles` is a row-major grid of mini tiles of the whole layer.
+    TileLayerComponent CollectLayerTiles(const nlohmann::json& layer, ZOrderingType zOrderingType, std::vector<bool>& visibleMiniTiles);
     void ParseObjectLayer(const nlohmann::json& layer);
     void CalculateLevelBoundsWithBufferZone();
     void ParseTile(int tileId, int layerCol, int layerRow, SpawnTileOption tileOptions);
+    // Spawn the quadtree node of the tile as one tile if all its mini tiles are visible. Otherwise subdivide it.
+    // `nodeMiniRect` is in the mini tiles of the tile. `visibleMiniTiles` is a row-major grid of mini tiles of the tile.
+    void ParseTileNode(
+        const SDL_Rect& textureSrcRect, const std::vector<bool>& visibleMiniTiles, int layerCol, int layerRow, const SDL_Rect& nodeMiniRect,
+        SpawnTileOption tileOptions);
 private: // Low level functions.
     std::filesystem::path ReadPathToTileset(const nlohmann::json& mapJson);
     void RecreateBox2dWorld();
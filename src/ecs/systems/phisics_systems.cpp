@@ -1,4 +1,5 @@
 #include "phisics_systems.h"
+#include <algorithm>
 #include <ecs/components/physics_components.h>
 #include <ecs/components/player_components.h>
 #include <ecs/components/portal_components.h>
@@ -9,50 +10,116 @@
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/math_utils.h>
 
-PhysicsSystem::PhysicsSystem(EnttRegistryWrapper& registryWrapper)
+PhysicsSystem::PhysicsSystem(EnttRegistryWrapper& registryWrapper, Box2dEnttContactListener& contactListener)
   : registryWrapper(registryWrapper), registry(registryWrapper), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())),
-    coordinatesTransformer(registry)
+    contactListener(contactListener), coordinatesTransformer(registry)
 {}
 
 void PhysicsSystem::Update(float deltaTime)
 {
+    auto& fixedTimeStep = utils::GetConfig<float, "PhysicsSystem.fixedTimeStep">();
+    auto& maxSubSteps = utils::GetConfig<int, "PhysicsSystem.maxSubSteps">();
+
+    if (fixedTimeStep <= 0.0f)
+    {
+        // Variable time step. The physics is stepped once per frame.
+        Step(deltaTime);
+        gameState.physicsOptions.interpolationAlpha = 1.0f;
+    }
+    else
+    {
+        // Drop the time which can't be simulated in `maxSubSteps`. Otherwise a slow frame makes the next frames even slower.
+        timeAccumulator = std::min(timeAccumulator + deltaTime, fixedTimeStep * maxSubSteps);
+        while (timeAccumulator >= fixedTimeStep)
+        {
+            Step(fixedTimeStep);
+            timeAccumulator -= fixedTimeStep;
+        }
+        gameState.physicsOptions.interpolationAlpha = timeAccumulator / fixedTimeStep;
+    }
+
+    UpdatePlayersWeaponDirection();
+    RemoveDistantObjects();
+}
+
+void PhysicsSystem::Step(float timeStep)
+{
+    SavePreviousTransforms();
+
     // Update the physics world with Box2D engine.
     auto& velocityIterations = utils::GetConfig<int, "PhysicsSystem.velocityIterations">();
     auto& positionIterations = utils::GetConfig<int, "PhysicsSystem.positionIterations">();
-    gameState.physicsWorld->Step(deltaTime, velocityIterations, positionIterations);
+    gameState.physicsWorld->Step(timeStep, velocityIterations, positionIterations);
 
     UpdateAngleRegardingWithAnglePolicy();
-    UpdatePlayersWeaponDirection();
-    RemoveDistantObjects();
+    UpdateTransformCache();
+
+    // Contact listeners are allowed to change the world after the step.
+    contactListener.DispatchBufferedContacts();
+}
+
+void PhysicsSystem::SavePreviousTransforms()
+{
+    // Previous transform of the static body is equal to the current one. See Box2dBodyTuner::UpdateTransformComponent.
+    auto transforms = registry.view<DynamicBodyComponent, TransformComponent>();
+    for (auto entity : transforms)
+    {
+        auto& transform = transforms.get<TransformComponent>(entity);
+        transform.previousPositionPhysics = transform.positionPhysics;
+        transform.previousAngle = transform.angle;
+    }
+}
+
+void PhysicsSystem::UpdateTransformCache()
+{
+    const auto& levelBounds = gameState.levelOptions.levelBox2dBounds;
+
+    auto physicsComponents = registry.view<DynamicBodyComponent, PhysicsComponent, TransformComponent>();
+    for (auto entity : physicsComponents)
+    {
+        const auto& [physicsComponent, transform] = physicsComponents.get<PhysicsComponent, TransformComponent>(entity);
+        const b2Body* body = physicsComponent.body;
+        if (!body->IsAwake())
+            continue;
+
+        const b2Transform& bodyTransform = body->GetTransform();
+        transform.positionPhysics = bodyTransform.p;
+        transform.angle = body->GetAngle();
+        transform.positionWorld = coordinatesTransformer.PhysicsToWorld(bodyTransform.p);
+
+        // Only moved bodies may leave the level. Destroyed after all steps of the update.
+        if (!utils::IsPointInsideBounds(transform.positionPhysics, levelBounds))
+            distantEntities.push_back(entity);
+    }
 }
 
 void PhysicsSystem::RemoveDistantObjects()
 {
-    auto levelBounds = gameState.levelOptions.levelBox2dBounds;
+    const auto& levelBounds = gameState.levelOptions.levelBox2dBounds;
 
-    auto physicalBodies = registry.view<PhysicsComponent>();
-    for (auto entity : physicalBodies)
+    for (auto entity : distantEntities)
     {
-        auto& physicalBody = physicalBodies.get<PhysicsComponent>(entity);
-        b2Vec2 posPhysics = physicalBody.bodyRAII->GetBody()->GetPosition();
+        // Entity may be collected on several steps or destroyed by the contact listeners.
+        if (!registry.valid(entity))
+            continue;
 
-        if (!utils::IsPointInsideBounds(posPhysics, levelBounds))
-        {
+        const auto* transform = registry.try_get<TransformComponent>(entity);
+        if (transform && !utils::IsPointInsideBounds(transform->positionPhysics, levelBounds))
             registryWrapper.Destroy(entity);
-        }
     }
+    distantEntities.clear();
 }
 
 // Set the direction of the weapon of the player to the last mouse position.
 void PhysicsSystem::UpdatePlayersWeaponDirection()
 {
-    auto players = registry.view<PhysicsComponent, PlayerComponent>();
+    auto players = registry.view<TransformComponent, PlayerComponent>();
     for (auto entity : players)
     {
-        const auto& [physicalBody, playerInfo] = players.get<PhysicsComponent, PlayerComponent>(entity);
+        const auto& [transform, playerInfo] = players.get<TransformComponent, PlayerComponent>(entity);
 
         auto& lastMousePosInWindow = gameState.windowOptions.lastMousePosInWindow;
-        glm::vec2 playerPosInWindow = coordinatesTransformer.PhysicsToScreen(physicalBody.bodyRAII->GetBody()->GetPosition());
+        glm::vec2 playerPosInWindow = coordinatesTransformer.WorldToScreen(transform.positionWorld);
 
         playerInfo.weaponDirection = glm::normalize(lastMousePosInWindow - playerPosInWindow);
     }
@@ -60,27 +127,14 @@ void PhysicsSystem::UpdatePlayersWeaponDirection()
 
 void PhysicsSystem::UpdateAngleRegardingWithAnglePolicy()
 {
-    auto physicsComponens = registry.view<PhysicsComponent>();
-    for (auto entity : physicsComponens)
+    // Fixed and Dynamic policies are applied to the body once by Box2dBodyTuner.
+    auto velocityDirectionBodies = registry.view<PhysicsComponent, VelocityDirectionAngleComponent>();
+    for (auto entity : velocityDirectionBodies)
     {
-        auto& physicsComponent = physicsComponens.get<PhysicsComponent>(entity);
-        auto body = physicsComponent.bodyRAII->GetBody();
-
-        if (physicsComponent.options.anglePolicy == Box2dBodyOptions::AnglePolicy::VelocityDirection)
-        {
-            b2Vec2 velocity = body->GetLinearVelocity();
-            float angle = utils::GetAngleFromDirection(velocity);
-            body->SetTransform(body->GetPosition(), angle);
-        }
-
-        if (physicsComponent.options.anglePolicy == Box2dBodyOptions::AnglePolicy::Fixed)
-        {
-            body->SetFixedRotation(true);
-        }
-
-        if (physicsComponent.options.anglePolicy == Box2dBodyOptions::AnglePolicy::Dynamic)
-        {
-            body->SetFixedRotation(false);
-        }
+        auto body = velocityDirectionBodies.get<PhysicsComponent>(entity).body;
+        b2Vec2 velocity = body->GetLinearVelocity();
+        float angle = utils::GetAngleFromDirection(velocity);
+        // Called between the step and UpdateTransformCache, so the cached position is one step behind the body.
+        body->SetTransform(body->GetPosition(), angle);
     }
 }
@@ -4,17 +4,28 @@
 #include <utils/coordinates_transformer.h>
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/game_options.h>
+#include <utils/systems/box2d_entt_contact_listener.h>
+#include <vector>
 
 class PhysicsSystem
 {
     EnttRegistryWrapper& registryWrapper;
     entt::registry& registry;
     GameOptions& gameState;
+    Box2dEnttContactListener& contactListener;
     CoordinatesTransformer coordinatesTransformer;
+    float timeAccumulator = 0.0f; // Time not simulated yet. Less than one fixed step after the update.
+    std::vector<entt::entity> distantEntities; // Moved outside the level bounds during the steps of the update.
 public:
-    PhysicsSystem(EnttRegistryWrapper& registryWrapper);
+    PhysicsSystem(EnttRegistryWrapper& registryWrapper, Box2dEnttContactListener& contactListener);
+    // Run as many fixed steps as fit into the accumulated time. Not more than `PhysicsSystem.maxSubSteps` per update.
     void Update(float deltaTime);
 private:
+    void Step(float timeStep);
+    void SavePreviousTransforms();
+    // Copy transforms of the moved bodies to TransformComponent. Called once after each physics step.
+    // Bodies moved outside the level bounds are collected to `distantEntities`.
+    void UpdateTransformCache();
     void RemoveDistantObjects();
     void UpdatePlayersWeaponDirection();
     void UpdateAngleRegardingWithAnglePolicy();
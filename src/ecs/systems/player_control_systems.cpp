@@ -68,7 +68,7 @@ void PlayerControlSystem::ProcessEventsQueue(float deltaTime)
 void PlayerControlSystem::RestrictPlayerHorizontalSpeed(entt::entity playerEntity)
 {
     const auto& [player, physicalBody] = registry.get<PlayerComponent, PhysicsComponent>(playerEntity);
-    auto body = physicalBody.bodyRAII->GetBody();
+    auto body = physicalBody.body;
 
     auto velocity = body->GetLinearVelocity();
     float maxHorizontalSpeed = utils::GetConfig<float, "PlayerControlSystem.maxHorizontalSpeed">();
@@ -98,10 +98,12 @@ void PlayerControlSystem::SubscribeToInputEvents()
 
 void PlayerControlSystem::SubscribeToContactListener()
 {
-    contactListener.SubscribeContact(
-        Box2dEnttContactListener::ContactType::BeginSensor, [this](const Box2dEnttContactListener::ContactInfo& contactInfo) { HandlePlayerBeginPlayerContact(contactInfo); });
-    contactListener.SubscribeContact(
-        Box2dEnttContactListener::ContactType::EndSensor, [this](const Box2dEnttContactListener::ContactInfo& contactInfo) { HandlePlayerEndPlayerContact(contactInfo); });
+    contactListener.SubscribeContact<PlayerComponent>(
+        Box2dEnttContactListener::ContactType::BeginSensor,
+        [this](std::span<const Box2dEnttContactListener::ContactInfo> contactInfos) { HandlePlayerBeginPlayerContact(contactInfos); });
+    contactListener.SubscribeContact<PlayerComponent>(
+        Box2dEnttContactListener::ContactType::EndSensor,
+        [this](std::span<const Box2dEnttContactListener::ContactInfo> contactInfos) { HandlePlayerEndPlayerContact(contactInfos); });
 }
 
 void PlayerControlSystem::HandlePlayerMovement(const InputEventManager::EventInfo& eventInfo, float deltaTime)
@@ -112,7 +114,7 @@ void PlayerControlSystem::HandlePlayerMovement(const InputEventManager::EventInf
     for (auto entity : players)
     {
         const auto& [player, physicalBody] = players.get<PlayerComponent, PhysicsComponent>(entity);
-        auto body = physicalBody.bodyRAII->GetBody();
+        auto body = physicalBody.body;
 
         bool allowLeftRightMovement = utils::GetConfig<bool, "PlayerControlSystem.allowLeftRightMovementInAir">() || player.OnGround();
 
@@ -222,14 +224,13 @@ void PlayerControlSystem::HandlePlayerWeaponDirection(const InputEventManager::E
 
     if (event.type == SDL_MOUSEMOTION)
     {
-        const auto& players = registry.view<PlayerComponent, PhysicsComponent>();
+        const auto& players = registry.view<PlayerComponent, TransformComponent>();
         for (auto entity : players)
         {
-            const auto& [playerInfo, physicalBody] = players.get<PlayerComponent, PhysicsComponent>(entity);
-            auto playerBody = physicalBody.bodyRAII->GetBody();
+            const auto& [playerInfo, transform] = players.get<PlayerComponent, TransformComponent>(entity);
 
             glm::vec2 mousePosScreen{event.motion.x, event.motion.y};
-            glm::vec2 playerPosScreen = coordinatesTransformer.PhysicsToScreen(playerBody->GetPosition());
+            glm::vec2 playerPosScreen = coordinatesTransformer.PhysicsToScreen(transform.positionPhysics);
             glm::vec2 directionVec = mousePosScreen - playerPosScreen;
             playerInfo.weaponDirection = glm::normalize(directionVec);
         }
@@ -269,20 +270,29 @@ void PlayerControlSystem::HandlePlayerChangeWeapon(const InputEventManager::Even
     }
 }
 
-void PlayerControlSystem::HandlePlayerEndPlayerContact(const Box2dEnttContactListener::ContactInfo& contactInfo)
+void PlayerControlSystem::HandlePlayerEndPlayerContact(std::span<const Box2dEnttContactListener::ContactInfo> contactInfos)
 {
-    SetGroundContactFlagIfEntityIsPlayer(contactInfo.entityA, false);
-    SetGroundContactFlagIfEntityIsPlayer(contactInfo.entityB, false);
+    for (const auto& contactInfo : contactInfos)
+    {
+        SetGroundContactFlagIfEntityIsPlayer(contactInfo.entityA, false);
+        SetGroundContactFlagIfEntityIsPlayer(contactInfo.entityB, false);
+    }
 }
 
-void PlayerControlSystem::HandlePlayerBeginPlayerContact(const Box2dEnttContactListener::ContactInfo& contactInfo)
+void PlayerControlSystem::HandlePlayerBeginPlayerContact(std::span<const Box2dEnttContactListener::ContactInfo> contactInfos)
 {
-    SetGroundContactFlagIfEntityIsPlayer(contactInfo.entityA, true);
-    SetGroundContactFlagIfEntityIsPlayer(contactInfo.entityB, true);
+    for (const auto& contactInfo : contactInfos)
+    {
+        SetGroundContactFlagIfEntityIsPlayer(contactInfo.entityA, true);
+        SetGroundContactFlagIfEntityIsPlayer(contactInfo.entityB, true);
+    }
 }
 
 void PlayerControlSystem::SetGroundContactFlagIfEntityIsPlayer(entt::entity entity, bool value)
 {
+    if (!registry.valid(entity))
+        return;
+
     auto playerInfo = registry.try_get<PlayerComponent>(entity);
     if (playerInfo)
     {
@@ -360,10 +370,9 @@ entt::entity PlayerControlSystem::MakeShotIfPossible(entt::entity playerEntity,
     const WeaponProps& weaponProps = playerInfo.weapons.at(playerInfo.currentWeapon);
 
     // Caclulate initial bullet position.
-    const auto& playerBody = registry.get<PhysicsComponent>(playerEntity).bodyRAII->GetBody();
     const auto& playerAnimationComponent = registry.get<AnimationComponent>(playerEntity);
     glm::vec2 playerSizeWorld = playerAnimationComponent.GetHitboxSize();
-    glm::vec2 playerPosWorld = coordinatesTransformer.PhysicsToWorld(playerBody->GetPosition());
+    glm::vec2 playerPosWorld = registry.get<TransformComponent>(playerEntity).positionWorld;
     auto weaponInitialPointShift = playerInfo.weaponDirection * (playerSizeWorld.x) / 2.0f;
     glm::vec2 initialPosWorld = playerPosWorld + weaponInitialPointShift;
 
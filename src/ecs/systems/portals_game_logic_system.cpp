@@ -23,35 +23,57 @@ void PortalsGameLogicSystem::Update(float deltaTime)
     if (!enabled)
         return;
 
-    UpdatePortalsPosition(deltaTime);
-    MagnetFoodToPortal(deltaTime);
-    DestroyClosestFoodInPortal();
-    ScatterPortalsIsTheyCloseToEachOther();
-    EatThePlayerByPortalIfCloser();
+    auto grids = BuildFrameGrids();
+    UpdatePortalsPosition(grids, deltaTime);
+    MagnetFoodToPortal(grids, deltaTime);
+    DestroyClosestFoodInPortal(grids);
+    ScatterPortalsIsTheyCloseToEachOther(grids);
+    EatThePlayerByPortalIfCloser(grids);
     CheckGameCompletness();
 }
 
-void PortalsGameLogicSystem::UpdatePortalsPosition(float deltaTime)
+PortalsGameLogicSystem::PortalAnchors PortalsGameLogicSystem::CollectPortalAnchors(bool skipSleeping)
 {
-    if (deltaTime == 0.0f)
-        return;
-
-    auto portalEntities = registry.view<PhysicsComponent, PortalComponent>();
+    PortalAnchors portals;
+    auto portalEntities = registry.view<TransformComponent, PortalComponent>();
     for (auto portalEntity : portalEntities)
     {
-        auto& portalComponent = portalEntities.get<PortalComponent>(portalEntity);
-        if (portalComponent.isSleeping)
+        if (skipSleeping && portalEntities.get<PortalComponent>(portalEntity).isSleeping)
             continue;
 
-        UpdatePortalTarget(portalEntity);
+        portals.entities.push_back(portalEntity);
+        portals.positionsPhysics.push_back(portalEntities.get<TransformComponent>(portalEntity).positionPhysics);
+    }
+    return portals;
+}
+
+PortalsGameLogicSystem::FrameGrids PortalsGameLogicSystem::BuildFrameGrids()
+{
+    return FrameGrids{
+        request::BuildPointGridWithAllComponents<ExplostionParticlesComponent>(registry),
+        request::BuildPointGridWithAllComponents<StickyComponent>(registry),
+        request::BuildPointGridWithAllComponents<PlayerComponent>(registry),
+        request::BuildPointGridWithAllComponents<PortalComponent>(registry)};
+}
+
+void PortalsGameLogicSystem::UpdatePortalsPosition(const FrameGrids& grids, float deltaTime)
+{
+    if (deltaTime == 0.0f)
+        return;
+
+    auto portals = CollectPortalAnchors(true);
+    UpdatePortalsTarget(grids, portals);
+
+    for (size_t i = 0; i < portals.entities.size(); ++i)
+    {
+        auto portalEntity = portals.entities[i];
+        auto& portalComponent = registry.get<PortalComponent>(portalEntity);
         if (!portalComponent.target)
             continue;
 
         // Apply the force to phiysics body to move it to the closest target
-        auto& physicsComponent = portalEntities.get<PhysicsComponent>(portalEntity);
-        auto portalBody = physicsComponent.bodyRAII->GetBody();
-        auto portalPos = portalBody->GetPosition();
-        b2Vec2 direction = portalComponent.target->second - portalPos;
+        auto portalBody = registry.get<PhysicsComponent>(portalEntity).body;
+        b2Vec2 direction = portalComponent.target->second - portals.positionsPhysics[i];
         direction.Normalize();
         // change object speed to the target speed
         b2Vec2 speed = portalBody->GetLinearVelocity();
@@ -62,67 +84,64 @@ void PortalsGameLogicSystem::UpdatePortalsPosition(float deltaTime)
     }
 }
 
-void PortalsGameLogicSystem::UpdatePortalTarget(entt::entity portalEntity)
+void PortalsGameLogicSystem::UpdatePortalsTarget(const FrameGrids& grids, const PortalAnchors& portals)
 {
     if (utils::GetConfig<bool, "PortalsGameLogicSystem.debugOnlyNoTargetForPortal">())
         return;
 
-    auto& portal = registry.get<PortalComponent>(portalEntity);
-    auto& physicsComponent = registry.get<PhysicsComponent>(portalEntity);
-    auto portalBody = physicsComponent.bodyRAII->GetBody();
-    auto portalPos = portalBody->GetPosition();
+    auto getPos = [this](entt::entity entity) { return registry.get<TransformComponent>(entity).positionPhysics; };
 
-    std::optional<std::pair<PortalComponent::PortalTargetType, b2Vec2>> newTarget;
-
-    auto closestExplosionParticlesPos = request::FindClosestEntityPosWithAllComponents<ExplostionParticlesComponent>(registry, portalPos);
-    if (closestExplosionParticlesPos.has_value())
+    for (size_t i = 0; i < portals.entities.size(); ++i)
     {
-        // If the closest explosion particles are too close to the portal, return this position.
-        if (b2Distance(closestExplosionParticlesPos.value(), portalPos) < 3.0f)
-            newTarget = std::make_pair(PortalComponent::PortalTargetType::DestructibleParticle, closestExplosionParticlesPos.value());
-    }
+        auto& portal = registry.get<PortalComponent>(portals.entities[i]);
+        const auto& portalPos = portals.positionsPhysics[i];
 
-    auto closestStickyPos = request::FindClosestEntityPosWithAllComponents<StickyComponent>(registry, portalPos);
-    if (!newTarget && closestStickyPos.has_value())
-        portal.target = std::make_pair(PortalComponent::PortalTargetType::DestructibleParticle, closestStickyPos.value());
+        std::optional<std::pair<PortalComponent::PortalTargetType, b2Vec2>> newTarget;
 
-    auto closestPlayer = request::FindClosestEntityWithAllComponents<PlayerComponent>(registry, portalPos);
-    if (!newTarget && closestPlayer.has_value())
-    {
-        const auto& playerPos = registry.get<PhysicsComponent>(closestPlayer.value()).bodyRAII->GetBody()->GetPosition();
-        newTarget = std::make_pair(PortalComponent::PortalTargetType::Player, playerPos);
-    }
+        if (auto closestExplosionParticles = grids.explosionParticles.FindClosest(portalPos))
+        {
+            // If the closest explosion particles are too close to the portal, return this position.
+            auto closestExplosionParticlesPos = getPos(closestExplosionParticles.value());
+            if (b2Distance(closestExplosionParticlesPos, portalPos) < 3.0f)
+                newTarget = std::make_pair(PortalComponent::PortalTargetType::DestructibleParticle, closestExplosionParticlesPos);
+        }
 
-    // Play the sound effect if the target is changed to the player.
-    if (newTarget && newTarget->first == PortalComponent::PortalTargetType::Player)
-    {
-        if ((portal.target && portal.target->first != PortalComponent::PortalTargetType::Player) || !portal.target)
-            audioSystem.PlaySoundEffect("portal_go_to_player");
-    }
+        if (!newTarget)
+        {
+            if (auto closestSticky = grids.stickies.FindClosest(portalPos))
+                portal.target = std::make_pair(PortalComponent::PortalTargetType::DestructibleParticle, getPos(closestSticky.value()));
+        }
+
+        if (!newTarget)
+        {
+            if (auto closestPlayer = grids.players.FindClosest(portalPos))
+                newTarget = std::make_pair(PortalComponent::PortalTargetType::Player, getPos(closestPlayer.value()));
+        }
 
-    portal.target = newTarget;
+        // Play the sound effect if the target is changed to the player.
+        if (newTarget && newTarget->first == PortalComponent::PortalTargetType::Player)
+        {
+            if ((portal.target && portal.target->first != PortalComponent::PortalTargetType::Player) || !portal.target)
+                audioSystem.PlaySoundEffect("portal_go_to_player");
+        }
+
+        portal.target = newTarget;
+    }
 }
 
-void PortalsGameLogicSystem::MagnetFoodToPortal(float deltaTime)
+void PortalsGameLogicSystem::MagnetFoodToPortal(const FrameGrids& grids, float deltaTime)
 {
-    auto portalEntities = registry.view<PhysicsComponent, PortalComponent>();
-    for (auto entity : portalEntities)
-    {
-        auto& portalComponent = portalEntities.get<PortalComponent>(entity);
-        if (portalComponent.isSleeping)
-            continue;
-
-        auto& physicsComponent = portalEntities.get<PhysicsComponent>(entity);
-        auto portalBody = physicsComponent.bodyRAII->GetBody();
-        auto portalPos = portalBody->GetPosition();
+    auto portals = CollectPortalAnchors(true);
 
-        auto entitiesToMagnet = request::FindEntitiesWithAllComponentsInRadius<ExplostionParticlesComponent>(registry, portalPos, 6.0f);
+    for (size_t i = 0; i < portals.entities.size(); ++i)
+    {
+        const auto& portalComponent = registry.get<PortalComponent>(portals.entities[i]);
+        const auto& portalPos = portals.positionsPhysics[i];
 
-        for (auto entityToMagnet : entitiesToMagnet)
+        for (auto entityToMagnet : grids.explosionParticles.FindInRadius(portalPos, 6.0f))
         {
-            auto& physicsComponentToMagnet = registry.get<PhysicsComponent>(entityToMagnet);
-            auto bodyToMagnet = physicsComponentToMagnet.bodyRAII->GetBody();
-            auto bodyPos = bodyToMagnet->GetPosition();
+            auto bodyToMagnet = registry.get<PhysicsComponent>(entityToMagnet).body;
+            const auto& bodyPos = registry.get<TransformComponent>(entityToMagnet).positionPhysics;
             b2Vec2 direction = portalPos - bodyPos;
             direction.Normalize();
             float distance = b2Distance(portalPos, bodyPos);
@@ -132,63 +151,63 @@ void PortalsGameLogicSystem::MagnetFoodToPortal(float deltaTime)
     }
 }
 
-void PortalsGameLogicSystem::DestroyClosestFoodInPortal()
+void PortalsGameLogicSystem::DestroyClosestFoodInPortal(const FrameGrids& grids)
 {
-    auto portalEntities = registry.view<PhysicsComponent, PortalComponent>();
+    auto portals = CollectPortalAnchors(true);
 
     std::optional<entt::entity> portalToDestroyOpt;
 
-    portalEntities.each(
-        [this, &portalToDestroyOpt](entt::entity portalEntity, PhysicsComponent& portalPhysics, PortalComponent& portalComponent)
-        {
-            if (portalComponent.isSleeping)
-                return;
+    for (size_t i = 0; i < portals.entities.size(); ++i)
+    {
+        auto portalEntity = portals.entities[i];
+        auto& portalComponent = registry.get<PortalComponent>(portalEntity);
 
-            auto portalBody = portalPhysics.bodyRAII->GetBody();
-            auto portalPos = portalBody->GetPosition();
+        bool isFed = false;
+        for (auto entityInPortal : grids.explosionParticles.FindInRadius(portals.positionsPhysics[i], 0.1f))
+        {
+            // The food may be already eaten by the previous portal.
+            if (!registry.valid(entityInPortal))
+                continue;
 
-            auto entitiesInPortal = request::FindEntitiesWithAllComponentsInRadius<ExplostionParticlesComponent>(registry, portalPos, 0.1f);
-            if (entitiesInPortal.empty())
-                return;
+            portalComponent.foodCounter++;
+            isFed = true;
 
-            for (auto entityInPortal : entitiesInPortal)
+            const auto& portalMaxFoodCounter = utils::GetConfig<size_t, "PortalsGameLogicSystem.portalMaxFoodCounter">();
+            if (portalComponent.foodCounter >= portalMaxFoodCounter)
             {
-                portalComponent.foodCounter++;
-
-                const auto& portalMaxFoodCounter = utils::GetConfig<size_t, "PortalsGameLogicSystem.portalMaxFoodCounter">();
-                if (portalComponent.foodCounter >= portalMaxFoodCounter)
-                {
-                    auto portalPosWorld = coordinatesTransformer.PhysicsToWorld(portalPos);
-                    gameObjectsFactory.SpawnPlayer(portalPosWorld, "Rescued player");
-                    portalToDestroyOpt = portalEntity;
-                    return;
-                }
-
-                registryWrapper.Destroy(entityInPortal);
+                auto portalPosWorld = coordinatesTransformer.PhysicsToWorld(portals.positionsPhysics[i]);
+                gameObjectsFactory.SpawnPlayer(portalPosWorld, "Rescued player");
+                portalToDestroyOpt = portalEntity;
+                isFed = false;
+                break;
             }
 
+            registryWrapper.Destroy(entityInPortal);
+        }
+
+        if (isFed)
             audioSystem.PlaySoundEffect("portal_feeds");
-        });
+    }
 
     if (portalToDestroyOpt.has_value())
     {
         // Reset the food counter for all portals.
-        portalEntities.each([](entt::entity, PhysicsComponent&, PortalComponent& portalComponent) { portalComponent.foodCounter = 0; });
+        registry.view<PortalComponent>().each([](PortalComponent& portalComponent) { portalComponent.foodCounter = 0; });
         // Destroy one portal.
         registryWrapper.Destroy(portalToDestroyOpt.value());
     }
 }
 
-void PortalsGameLogicSystem::ScatterPortalsIsTheyCloseToEachOther()
+void PortalsGameLogicSystem::ScatterPortalsIsTheyCloseToEachOther(const FrameGrids& grids)
 {
-    auto portalEntities = registry.view<PhysicsComponent, PortalComponent>();
-    for (auto entity : portalEntities)
+    auto portals = CollectPortalAnchors(false);
+
+    for (const auto& portalPos : portals.positionsPhysics)
     {
-        auto& physicsComponent = portalEntities.get<PhysicsComponent>(entity);
-        auto portalBody = physicsComponent.bodyRAII->GetBody();
-        auto portalPos = portalBody->GetPosition();
+        // The portal fed by DestroyClosestFoodInPortal is already destroyed.
+        auto mergedPortals = grids.portals.FindInRadius(portalPos, 0.5f);
+        std::erase_if(mergedPortals, [this](entt::entity portal) { return !registry.valid(portal); });
 
-        auto mergedPortals = request::FindEntitiesWithAllComponentsInRadius<PortalComponent>(registry, portalPos, 0.5f);
         // If there are more than one portal in the same position, scatter them.
         if (mergedPortals.size() > 1)
         {
@@ -196,17 +215,15 @@ void PortalsGameLogicSystem::ScatterPortalsIsTheyCloseToEachOther()
             b2Vec2 mergePortalCenterPos = b2Vec2_zero;
             for (auto mergedPortal : mergedPortals)
             {
-                auto& mergedPortalPhysicsComponent = registry.get<PhysicsComponent>(mergedPortal);
-                mergePortalCenterPos += mergedPortalPhysicsComponent.bodyRAII->GetBody()->GetPosition();
+                mergePortalCenterPos += registry.get<TransformComponent>(mergedPortal).positionPhysics;
             }
             mergePortalCenterPos *= 1.0f / mergedPortals.size();
 
             // Apply the force to phiysics bodies to scatter them.
             for (auto portal : mergedPortals)
             {
-                auto& mergedPortalPhysicsComponent = registry.get<PhysicsComponent>(portal);
-                auto mergedPortalBody = mergedPortalPhysicsComponent.bodyRAII->GetBody();
-                b2Vec2 direction = mergedPortalBody->GetPosition() - mergePortalCenterPos;
+                auto mergedPortalBody = registry.get<PhysicsComponent>(portal).body;
+                b2Vec2 direction = registry.get<TransformComponent>(portal).positionPhysics - mergePortalCenterPos;
                 direction.Normalize();
                 mergedPortalBody->ApplyForceToCenter(500.0f * direction, true);
 
@@ -225,40 +242,36 @@ void PortalsGameLogicSystem::ScatterPortalsIsTheyCloseToEachOther()
     }
 }
 
-void PortalsGameLogicSystem::EatThePlayerByPortalIfCloser()
+void PortalsGameLogicSystem::EatThePlayerByPortalIfCloser(FrameGrids& grids)
 {
-    auto portalEntities = registry.view<PhysicsComponent, PortalComponent>();
-    portalEntities.each(
-        [this](auto portalEntity, auto& physicsComponent, auto& portalComponent)
-        {
-            if (portalComponent.isSleeping)
-                return;
-
-            auto portalBody = physicsComponent.bodyRAII->GetBody();
-            auto portalPos = portalBody->GetPosition();
+    auto portals = CollectPortalAnchors(true);
 
-            auto playerEntityOpt = request::FindClosestEntityWithAllComponents<PlayerComponent>(registry, portalPos);
+    for (size_t i = 0; i < portals.entities.size(); ++i)
+    {
+        auto portalEntity = portals.entities[i];
+        const auto& portalPos = portals.positionsPhysics[i];
 
-            if (!playerEntityOpt.has_value())
-                return;
+        // Eaten players are removed from the grid, so the next portals search among the rest.
+        auto playerEntityOpt = grids.players.FindClosest(portalPos);
+        if (!playerEntityOpt.has_value())
+            continue;
 
-            auto playerEntity = playerEntityOpt.value();
+        auto playerEntity = playerEntityOpt.value();
 
-            auto& playerPhysicsComponent = registry.get<PhysicsComponent>(playerEntity);
-            auto playerBody = playerPhysicsComponent.bodyRAII->GetBody();
-            auto playerBodyPos = playerBody->GetPosition();
+        const auto& playerBodyPos = registry.get<TransformComponent>(playerEntity).positionPhysics;
 
-            auto portalEatPlayerWithDistance = utils::GetConfig<float, "PortalsGameLogicSystem.portalEatPlayerWithDistance">();
-            if (b2Distance(portalPos, playerBodyPos) < portalEatPlayerWithDistance)
-            {
-                MY_LOG(debug, "Player {} is eaten by the portal {}!", playerEntity, portalEntity);
-                registryWrapper.Destroy(playerEntity);
+        auto portalEatPlayerWithDistance = utils::GetConfig<float, "PortalsGameLogicSystem.portalEatPlayerWithDistance">();
+        if (b2Distance(portalPos, playerBodyPos) < portalEatPlayerWithDistance)
+        {
+            MY_LOG(debug, "Player {} is eaten by the portal {}!", playerEntity, portalEntity);
+            grids.players.Remove(playerEntity, playerBodyPos);
+            registryWrapper.Destroy(playerEntity);
 
-                // Spawn a new portal near thisw place.
-                auto portalPosWorld = coordinatesTransformer.PhysicsToWorld(portalPos);
-                gameObjectsFactory.SpawnPortal(portalPosWorld, "Respawned portal");
-            }
-        });
+            // Spawn a new portal near thisw place.
+            auto portalPosWorld = coordinatesTransformer.PhysicsToWorld(portalPos);
+            gameObjectsFactory.SpawnPortal(portalPosWorld, "Respawned portal");
+        }
+    }
 }
 
 void PortalsGameLogicSystem::CheckGameCompletness()
@@ -4,6 +4,7 @@
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
 #include <utils/box2d/box2d_body_tuner.h>
+#include <utils/box2d/box2d_point_grid.h>
 #include <utils/coordinates_transformer.h>
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/factories/game_objects_factory.h>
@@ -11,6 +12,23 @@
 // TODO1: Remove this class later because of implementing new game.
 class PortalsGameLogicSystem
 {
+    // Portals with their positions. Positions are the anchors of the batched spatial queries.
+    struct PortalAnchors
+    {
+        std::vector<entt::entity> entities;
+        std::vector<b2Vec2> positionsPhysics;
+    };
+
+    // Grids of the entities the portals interact with. Built once per frame in Update. Entities destroyed during
+    // the frame stay in the grids (except the eaten players), so the helpers check them with `registry.valid`.
+    struct FrameGrids
+    {
+        Box2dPointGrid explosionParticles;
+        Box2dPointGrid stickies;
+        Box2dPointGrid players;
+        Box2dPointGrid portals;
+    };
+
     entt::registry& registry;
     EnttRegistryWrapper registryWrapper;
     Box2dBodyTuner bodyTuner;
@@ -22,11 +40,13 @@ public:
     PortalsGameLogicSystem(entt::registry& registry, GameObjectsFactory& gameObjectsFactory, AudioSystem& audioSystem);
     void Update(float deltaTime);
 private: ///////////////////////////////////////// Portal logic. ///////////////////////////////////////
-    void UpdatePortalsPosition(float deltaTime);
-    void UpdatePortalTarget(entt::entity portalEntity);
-    void MagnetFoodToPortal(float deltaTime);
-    void DestroyClosestFoodInPortal();
-    void ScatterPortalsIsTheyCloseToEachOther();
-    void EatThePlayerByPortalIfCloser();
+    PortalAnchors CollectPortalAnchors(bool skipSleeping);
+    FrameGrids BuildFrameGrids();
+    void UpdatePortalsPosition(const FrameGrids& grids, float deltaTime);
+    void UpdatePortalsTarget(const FrameGrids& grids, const PortalAnchors& portals);
+    void MagnetFoodToPortal(const FrameGrids& grids, float deltaTime);
+    void DestroyClosestFoodInPortal(const FrameGrids& grids);
+    void ScatterPortalsIsTheyCloseToEachOther(const FrameGrids& grids);
+    void EatThePlayerByPortalIfCloser(FrameGrids& grids);
     void CheckGameCompletness();
 };
\ No newline at end of file
@@ -53,7 +53,7 @@ void RenderHUDSystem::RenderDebugMenu()
     size_t dynamicBodiesCount = 0;
     for (auto entity : dynamicBodies)
     {
-        auto body = dynamicBodies.get<PhysicsComponent>(entity).bodyRAII->GetBody();
+        auto body = dynamicBodies.get<PhysicsComponent>(entity).body;
         if (body->GetType() == b2_dynamicBody)
             dynamicBodiesCount++;
     }
@@ -64,6 +64,12 @@ void RenderHUDSystem::RenderDebugMenu()
     ImGui::TextUnformatted(MY_FMT("{:.2f}/{:.2f} (Gr/Sc)", gravity, cameraScale).c_str());
     ImGui::TextUnformatted(MY_FMT("{}/{}/{} (Ts/Ps/DB)", tiles.size(), players.size(), dynamicBodiesCount).c_str());
     ImGui::TextUnformatted(MY_FMT("Camera center: {}", gameState.windowOptions.cameraCenterSdl).c_str());
+    if (gameState.bodyPool)
+    {
+        const auto& poolStats = gameState.bodyPool->GetStats();
+        ImGui::TextUnformatted(
+            MY_FMT("{}/{}/{} (Body pool Hit/Miss/Size)", poolStats.hits, poolStats.misses, gameState.bodyPool->GetPooledBodiesCount()).c_str());
+    }
 
     // Print debug info.
     ImGui::TextUnformatted(MY_FMT("Space pressed duration: {:.2f}", gameState.debugInfo.spacePressedDuration).c_str());
@@ -7,6 +7,7 @@
 #include <ecs/components/rendering_components.h>
 #include <my_cpp_utils/config.h>
 #include <utils/box2d/box2d_glm_operators.h>
+#include <utils/box2d/box2d_interpolation.h>
 #include <utils/debug_tools/debug_draw_bounding_box.h>
 #include <utils/logger.h>
 #include <utils/sdl/sdl_colors.h>
@@ -45,31 +46,40 @@ void RenderWorldSystem::RenderTiles()
 {
     for (const auto zOrderingType : magic_enum::enum_values<ZOrderingType>())
     {
-        auto tilesView = registry.view<TileComponent, PhysicsComponent>();
+        auto tilesView = registry.view<TileComponent, TransformComponent>();
         for (auto entity : tilesView)
         {
-            const auto& [tileComponent, physicalBody] = tilesView.get<TileComponent, PhysicsComponent>(entity);
+            const auto& [tileComponent, transform] = tilesView.get<TileComponent, TransformComponent>(entity);
             if (tileComponent.zOrderingType != zOrderingType)
                 continue;
 
-            const glm::vec2 posWorld = coordinatesTransformer.PhysicsToWorld(physicalBody.bodyRAII->GetBody()->GetPosition());
-            const float angle = physicalBody.bodyRAII->GetBody()->GetAngle();
+            const float alpha = gameState.physicsOptions.interpolationAlpha;
+            const glm::vec2 posWorld = coordinatesTransformer.PhysicsToWorld(utils::GetInterpolatedPosition(transform, alpha));
+            const float angle = utils::GetInterpolatedAngle(transform, alpha);
             primitivesRenderer.RenderTile(tileComponent, posWorld, angle);
         }
+
+        auto tileLayersView = registry.view<TileLayerComponent>();
+        for (auto entity : tileLayersView)
+        {
+            const auto& tileLayer = tileLayersView.get<TileLayerComponent>(entity);
+            if (tileLayer.zOrderingType == zOrderingType)
+                primitivesRenderer.RenderTileLayer(tileLayer);
+        }
     }
 }
 
 void RenderWorldSystem::RenderPlayerWeaponDirection()
 {
-    auto players = registry.view<PhysicsComponent, PlayerComponent, AnimationComponent>();
+    auto players = registry.view<TransformComponent, PlayerComponent, AnimationComponent>();
     for (auto entity : players)
     {
-        auto [physicalBody, playerInfo, animationComponent] = players.get<PhysicsComponent, PlayerComponent, AnimationComponent>(entity);
+        auto [transform, playerInfo, animationComponent] = players.get<TransformComponent, PlayerComponent, AnimationComponent>(entity);
 
         // Draw the weapon.
         // TODO1: Currently we are always get the animation in initial state. So it always draws the first frame.
         // We should use AnimationComponent to make weapon animation runnable.
-        const glm::vec2 playerPosWorld = coordinatesTransformer.PhysicsToWorld(physicalBody.bodyRAII->GetBody()->GetPosition());
+        const glm::vec2 playerPosWorld = coordinatesTransformer.PhysicsToWorld(utils::GetInterpolatedPosition(transform, gameState.physicsOptions.interpolationAlpha));
         float angle = utils::GetAngleFromDirection(playerInfo.weaponDirection);
         auto weaponAnimation = resourceManager.GetAnimation("scepter");
         SDL_RendererFlip weaponFlip = animationComponent.flip == SDL_FLIP_HORIZONTAL ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE;
@@ -79,17 +89,16 @@ void RenderWorldSystem::RenderPlayerWeaponDirection()
 
 void RenderWorldSystem::RenderAnimations()
 {
-    auto view = registry.view<AnimationComponent, PhysicsComponent>();
+    auto view = registry.view<AnimationComponent, TransformComponent>();
 
     for (auto entity : view)
     {
-        const auto& [animationInfo, physicsInfo] = view.get<AnimationComponent, PhysicsComponent>(entity);
+        const auto& [animationInfo, transform] = view.get<AnimationComponent, TransformComponent>(entity);
 
         // Caclulate the position and angle of the animation.
-        auto body = physicsInfo.bodyRAII->GetBody();
-
-        glm::vec2 physicsBodyCenterWorld = coordinatesTransformer.PhysicsToWorld(body->GetPosition());
-        const float angle = body->GetAngle();
+        const float alpha = gameState.physicsOptions.interpolationAlpha;
+        glm::vec2 physicsBodyCenterWorld = coordinatesTransformer.PhysicsToWorld(utils::GetInterpolatedPosition(transform, alpha));
+        const float angle = utils::GetInterpolatedAngle(transform, alpha);
 
         primitivesRenderer.RenderAnimationComponent(animationInfo, physicsBodyCenterWorld, angle);
 
@@ -0,0 +1,305 @@
+#include "terrain_system.h"
+#include <chrono>
+#include <cmath>
+#include <ecs/components/physics_components.h>
+#include <ecs/components/rendering_components.h>
+#include <ecs/components/terrain_components.h>
+#include <my_cpp_utils/config.h>
+#include <utils/box2d/box2d_glm_operators.h>
+#include <utils/logger.h>
+#include <utils/terrain/terrain_contours.h>
+#include <utils/terrain/terrain_mask.h>
+
+namespace
+{
+
+// Box2D callback to wake up all non static bodies which AABB overlaps the query AABB.
+class WakeUpBodiesQueryCallback : public b2QueryCallback
+{
+public:
+    bool ReportFixture(b2Fixture* fixture) override
+    {
+        b2Body* body = fixture->GetBody();
+        if (body->GetType() != b2_staticBody)
+            body->SetAwake(true);
+        return true; // Continue the query.
+    }
+};
+
+} // namespace
+
+TerrainSystem::TerrainSystem(EnttRegistryWrapper& registryWrapper, BaseObjectsFactory& baseObjectsFactory)
+  : registryWrapper(registryWrapper), registry(registryWrapper), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())), baseObjectsFactory(baseObjectsFactory),
+    coordinatesTransformer(registry), bodyTuner(registry)
+{}
+
+void TerrainSystem::Update()
+{
+    auto terrains = registry.view<TerrainComponent, PhysicsComponent>();
+    for (auto entity : terrains)
+    {
+        auto& terrain = terrains.get<TerrainComponent>(entity);
+        if (SDL_RectEmpty(&terrain.dirtyRect))
+            continue;
+
+        UpdateTexture(terrain);
+        RebuildCollision(entity, terrain.dirtyRect);
+        WakeUpBodiesInRect(terrain, terrain.dirtyRect);
+
+        terrain.dirtyRect = {0, 0, 0, 0};
+    }
+}
+
+std::vector<entt::entity> TerrainSystem::CarveCircle(const b2Vec2& centerPhysics, float radiusPhysics, bool spawnDebris)
+{
+    std::vector<DebrisCell> debrisCells;
+
+    auto terrains = registry.view<TerrainComponent>();
+    for (auto entity : terrains)
+    {
+        auto& terrain = terrains.get<TerrainComponent>(entity);
+        glm::vec2 centerPixels = coordinatesTransformer.PhysicsToWorld(centerPhysics) - terrain.originWorld;
+        float radiusPixels = coordinatesTransformer.PhysicsToWorld(radiusPhysics);
+
+        // Debris are collected before carving because they are textured with the pixels which are going to be removed.
+        if (spawnDebris)
+        {
+            auto terrainDebrisCells = CollectDebrisCells(terrain, centerPixels, radiusPixels);
+            debrisCells.insert(debrisCells.end(), terrainDebrisCells.begin(), terrainDebrisCells.end());
+        }
+
+        SDL_Rect carvedRect = terrain.mask.CarveCircle(centerPixels, radiusPixels);
+        terrain.dirtyRect = utils::UniteRects(terrain.dirtyRect, carvedRect);
+    }
+
+    // Spawn debris outside of the view loop. Spawning adds new components to the registry.
+    SpawnTileOption debrisTileOptions{SpawnTileOption::CollidableOption::Collidable, SpawnTileOption::DesctructibleOption::Destructible, ZOrderingType::Terrain};
+    std::vector<BaseObjectsFactory::TileSpawn> debrisTiles;
+    debrisTiles.reserve(debrisCells.size());
+    for (const auto& debrisCell : debrisCells)
+        debrisTiles.push_back({debrisCell.posWorld, static_cast<float>(debrisCell.textureRect.rect.w), debrisCell.textureRect});
+    auto debrisEntities = baseObjectsFactory.SpawnTiles(debrisTiles, debrisTileOptions, "TerrainDebris");
+
+    MY_LOG(debug, "[TerrainSystem] Carved circle with radius {}. Spawned {} debris", radiusPhysics, debrisEntities.size());
+    return debrisEntities;
+}
+
+void TerrainSystem::SettleDebris(float deltaTime)
+{
+    auto& debrisSettleAfterSeconds = utils::GetConfig<float, "TerrainSystem.debrisSettleAfterSeconds">();
+    if (debrisSettleAfterSeconds <= 0.0f)
+        return;
+
+    std::vector<entt::entity> settledEntities;
+    auto particles = registry.view<ExplostionParticlesComponent, PhysicsComponent, TileComponent>();
+    for (auto entity : particles)
+    {
+        auto& particlesComponent = particles.get<ExplostionParticlesComponent>(entity);
+        const b2Body* body = particles.get<PhysicsComponent>(entity).body;
+        if (body->GetType() == b2_staticBody)
+            continue;
+
+        if (body->IsAwake())
+        {
+            particlesComponent.asleepSeconds = 0.0f;
+            continue;
+        }
+
+        particlesComponent.asleepSeconds += deltaTime;
+        if (particlesComponent.asleepSeconds >= debrisSettleAfterSeconds)
+            settledEntities.push_back(entity);
+    }
+
+    // Settle outside of the view loop. Settling destroys entities and changes their components.
+    for (auto entity : settledEntities)
+        SettleDebrisEntity(entity);
+
+    if (!settledEntities.empty())
+        MY_LOG(debug, "[TerrainSystem] Settled {} debris", settledEntities.size());
+}
+
+void TerrainSystem::SettleDebrisEntity(entt::entity debrisEntity)
+{
+    const auto& tile = registry.get<TileComponent>(debrisEntity);
+    glm::vec2 posWorld = registry.get<TransformComponent>(debrisEntity).positionWorld;
+
+    auto terrains = registry.view<TerrainComponent>();
+    for (auto terrainEntity : terrains)
+    {
+        auto& terrain = terrains.get<TerrainComponent>(terrainEntity);
+
+        // Only the debris textured from the tileset of the terrain can be stamped. The angle of the body is ignored.
+        if (!terrain.tilesetSurface || tile.texturePtr != terrain.tilesetTexture)
+            continue;
+
+        glm::vec2 topLeftPixels = posWorld - terrain.originWorld - glm::vec2(tile.textureRect.w, tile.textureRect.h) / 2.0f;
+        SDL_Point dstPoint{static_cast<int>(std::round(topLeftPixels.x)), static_cast<int>(std::round(topLeftPixels.y))};
+        SDL_Rect stampedRect = terrain.mask.StampFromSurface(terrain.tilesetSurface->get(), tile.textureRect, dstPoint);
+        if (SDL_RectEmpty(&stampedRect))
+            continue;
+
+        terrain.dirtyRect = utils::UniteRects(terrain.dirtyRect, stampedRect);
+        registryWrapper.Destroy(debrisEntity);
+        return;
+    }
+
+    // There is no bitmap terrain under the debris. Keep it as the static destructible tile.
+    bodyTuner.ApplyOption(debrisEntity, Box2dBodyOptions::MovementPolicy::Manual);
+    registry.remove<ExplostionParticlesComponent>(debrisEntity);
+}
+
+void TerrainSystem::UpdateTexture(TerrainComponent& terrain)
+{
+    if (!terrain.texture)
+        return;
+
+    const SDL_Rect& rect = terrain.dirtyRect;
+    const Uint32* pixels = terrain.mask.GetPixels() + rect.y * terrain.mask.GetWidth() + rect.x;
+    if (SDL_UpdateTexture(terrain.texture->get(), &rect, pixels, terrain.mask.GetPitch()) != 0)
+        MY_LOG(warn, "[TerrainSystem] Failed to update terrain texture: {}", SDL_GetError());
+}
+
+void TerrainSystem::RebuildCollision(entt::entity terrainEntity, const SDL_Rect& maskRect)
+{
+    auto& terrain = registry.get<TerrainComponent>(terrainEntity);
+    auto& collisionCellSize = utils::GetConfig<int, "TerrainSystem.collisionCellSize">();
+    auto& chunkSize = utils::GetConfig<int, "TerrainSystem.chunkSize">();
+    if (chunkSize <= 0 || collisionCellSize <= 0 || chunkSize % collisionCellSize != 0)
+        throw std::runtime_error(MY_FMT("[TerrainSystem] Chunk size {} must be a multiple of the collision cell size {}", chunkSize, collisionCellSize));
+
+    // Split the terrain to chunks on the first build.
+    if (terrain.chunkSize == 0)
+    {
+        terrain.chunkSize = chunkSize;
+        terrain.chunkCols = (terrain.mask.GetWidth() + chunkSize - 1) / chunkSize;
+        int chunkRows = (terrain.mask.GetHeight() + chunkSize - 1) / chunkSize;
+        terrain.chunkFixtures.resize(terrain.chunkCols * chunkRows);
+    }
+
+    // Changed cell also changes the marching squares of the previous cell. It may be in the neighbour chunk.
+    SDL_Rect affectedRect =
+        terrain.mask.ClipRect({maskRect.x - collisionCellSize, maskRect.y - collisionCellSize, maskRect.w + collisionCellSize, maskRect.h + collisionCellSize});
+    if (SDL_RectEmpty(&affectedRect))
+        return;
+
+    int firstChunkCol = affectedRect.x / terrain.chunkSize;
+    int firstChunkRow = affectedRect.y / terrain.chunkSize;
+    int lastChunkCol = (affectedRect.x + affectedRect.w - 1) / terrain.chunkSize;
+    int lastChunkRow = (affectedRect.y + affectedRect.h - 1) / terrain.chunkSize;
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<int> chunkIndices;
+    for (int chunkRow = firstChunkRow; chunkRow <= lastChunkRow; ++chunkRow)
+        for (int chunkCol = firstChunkCol; chunkCol <= lastChunkCol; ++chunkCol)
+            chunkIndices.push_back(chunkRow * terrain.chunkCols + chunkCol);
+
+    // Marching squares only read the mask. Box2D is not thread safe, so the fixtures are created on this thread.
+    std::vector<std::vector<TerrainContour>> contoursByChunk(chunkIndices.size());
+    gameState.taskScheduler->ParallelFor(
+        chunkIndices.size(),
+        [&](size_t i)
+        {
+            int chunkCol = chunkIndices[i] % terrain.chunkCols;
+            int chunkRow = chunkIndices[i] / terrain.chunkCols;
+            SDL_Rect chunkRect{chunkCol * terrain.chunkSize, chunkRow * terrain.chunkSize, terrain.chunkSize, terrain.chunkSize};
+            contoursByChunk[i] = utils::ExtractChunkContours(terrain.mask, chunkRect, collisionCellSize);
+        });
+
+    for (size_t i = 0; i < chunkIndices.size(); ++i)
+        ReplaceChunkFixtures(terrainEntity, chunkIndices[i], contoursByChunk[i]);
+
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+    rebuildStats.rebuildsCount++;
+    rebuildStats.chunksCount += chunkIndices.size();
+    rebuildStats.durationMs += duration.count();
+
+    MY_LOG(debug, "[TerrainSystem] Rebuilt collision of {} terrain chunks in {:.3f} ms", chunkIndices.size(), duration.count());
+}
+
+void TerrainSystem::ReplaceChunkFixtures(entt::entity terrainEntity, int chunkIndex, std::vector<TerrainContour>& contours)
+{
+    auto& terrain = registry.get<TerrainComponent>(terrainEntity);
+    auto& chunkFixtures = terrain.chunkFixtures[chunkIndex];
+
+    for (auto fixture : chunkFixtures)
+        bodyTuner.DestroyFixture(terrainEntity, fixture);
+    chunkFixtures.clear();
+
+    // Fixtures are placed relative to the body position which is the center of the mask.
+    glm::vec2 maskCenter = glm::vec2(terrain.mask.GetWidth(), terrain.mask.GetHeight()) / 2.0f;
+    for (auto& contour : contours)
+    {
+        for (auto& point : contour.points)
+            point -= maskCenter;
+
+        chunkFixtures.push_back(bodyTuner.AddChainFixture(terrainEntity, contour.points, contour.isLoop));
+    }
+}
+
+void TerrainSystem::LogStats() const
+{
+    MY_LOG(
+        info, "[TerrainSystem] {} collision rebuilds, {} chunks, {:.3f} ms total, {} worker threads", rebuildStats.rebuildsCount, rebuildStats.chunksCount,
+        rebuildStats.durationMs, gameState.taskScheduler ? gameState.taskScheduler->GetWorkersCount() : 0);
+}
+
+void TerrainSystem::WakeUpBodiesInRect(const TerrainComponent& terrain, const SDL_Rect& maskRect)
+{
+    // Bodies resting on the removed pixels are sleeping. Box2D does not wake them up when fixtures are destroyed.
+    auto& collisionCellSize = utils::GetConfig<int, "TerrainSystem.collisionCellSize">();
+    glm::vec2 margin(collisionCellSize, collisionCellSize);
+    glm::vec2 minWorld = terrain.originWorld + glm::vec2(maskRect.x, maskRect.y) - margin;
+    glm::vec2 maxWorld = terrain.originWorld + glm::vec2(maskRect.x + maskRect.w, maskRect.y + maskRect.h) + margin;
+
+    b2AABB aabb;
+    aabb.lowerBound = coordinatesTransformer.WorldToPhysics(minWorld);
+    aabb.upperBound = coordinatesTransformer.WorldToPhysics(maxWorld);
+
+    WakeUpBodiesQueryCallback callback;
+    gameState.physicsWorld->QueryAABB(&callback, aabb);
+}
+
+std::vector<TerrainSystem::DebrisCell> TerrainSystem::CollectDebrisCells(const TerrainComponent& terrain, const glm::vec2& centerPixels, float radiusPixels)
+{
+    std::vector<DebrisCell> debrisCells;
+
+    const int cellSize = terrain.debrisCellSize;
+    if (cellSize <= 0 || !terrain.tilesetTexture)
+        return debrisCells;
+
+    // Iterate over the cells of the debris grid which intersect the bounding box of the circle.
+    SDL_Rect circleRect = terrain.mask.ClipRect(
+        {static_cast<int>(centerPixels.x - radiusPixels), static_cast<int>(centerPixels.y - radiusPixels), static_cast<int>(radiusPixels * 2) + 1,
+         static_cast<int>(radiusPixels * 2) + 1});
+    int firstCellX = circleRect.x / cellSize * cellSize;
+    int firstCellY = circleRect.y / cellSize * cellSize;
+
+    for (int cellY = firstCellY; cellY < circleRect.y + circleRect.h; cellY += cellSize)
+    {
+        for (int cellX = firstCellX; cellX < circleRect.x + circleRect.w; cellX += cellSize)
+        {
+            // Cell becomes debris if its center is inside the circle and it is mostly solid.
+            glm::vec2 cellCenter(cellX + cellSize / 2.0f, cellY + cellSize / 2.0f);
+            if (glm::distance(cellCenter, centerPixels) > radiusPixels)
+                continue;
+
+            if (terrain.mask.CountSolid({cellX, cellY, cellSize, cellSize}) * 2 < cellSize * cellSize)
+                continue;
+
+            // Find original pixels of the cell in the tileset.
+            int tileIndex = (cellY / terrain.tileHeight) * terrain.layerCols + (cellX / terrain.tileWidth);
+            if (tileIndex < 0 || tileIndex >= static_cast<int>(terrain.tileTextureRects.size()))
+                continue;
+
+            const SDL_Rect& tileRect = terrain.tileTextureRects[tileIndex];
+            if (SDL_RectEmpty(&tileRect))
+                continue;
+
+            SDL_Rect cellTextureRect{tileRect.x + cellX % terrain.tileWidth, tileRect.y + cellY % terrain.tileHeight, cellSize, cellSize};
+            debrisCells.push_back({terrain.originWorld + cellCenter, TextureRect{terrain.tilesetTexture, cellTextureRect}});
+        }
+    }
+
+    return debrisCells;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <box2d/box2d.h>
+#include <ecs/components/terrain_components.h>
+#include <entt/entt.hpp>
+#include <utils/box2d/box2d_body_tuner.h>
+#include <utils/coordinates_transformer.h>
+#include <utils/entt/entt_registry_wrapper.h>
+#include <utils/factories/base_objects_factory.h>
+#include <utils/game_options.h>
+#include <utils/terrain/terrain_contours.h>
+
+// Keeps the bitmap terrain (TerrainComponent) in sync with its texture and Box2D fixtures.
+class TerrainSystem
+{
+    struct DebrisCell
+    {
+        glm::vec2 posWorld; // Center of the debris.
+        TextureRect textureRect; // Part of the tileset with the original pixels.
+    };
+
+    struct RebuildStats
+    {
+        size_t rebuildsCount = 0;
+        size_t chunksCount = 0;
+        double durationMs = 0.0; // Time of the contour extraction and the fixture creation.
+    };
+
+    EnttRegistryWrapper& registryWrapper;
+    entt::registry& registry;
+    GameOptions& gameState;
+    BaseObjectsFactory& baseObjectsFactory;
+    CoordinatesTransformer coordinatesTransformer;
+    Box2dBodyTuner bodyTuner;
+    RebuildStats rebuildStats;
+public:
+    TerrainSystem(EnttRegistryWrapper& registryWrapper, BaseObjectsFactory& baseObjectsFactory);
+    // Apply changes of the masks to the textures and the fixtures. Must not be called during Box2D step.
+    void Update();
+    // Carve the circle in all terrains. Return debris entities spawned from the carved pixels (if `spawnDebris` is true).
+    std::vector<entt::entity> CarveCircle(const b2Vec2& centerPhysics, float radiusPhysics, bool spawnDebris);
+    // Merge explosion particles asleep for `TerrainSystem.debrisSettleAfterSeconds` back to the static terrain.
+    void SettleDebris(float deltaTime);
+    // Log the time spent on the collision rebuilds. Used to compare the runs with the different `--workers N`.
+    void LogStats() const;
+private:
+    void UpdateTexture(TerrainComponent& terrain);
+    // Rebuild fixtures of the chunks intersecting the rect of the mask. Contours of the chunks are extracted in parallel.
+    void RebuildCollision(entt::entity terrainEntity, const SDL_Rect& maskRect);
+    // Replace fixtures of the chunk with the chains of `contours`. Contours are in pixels of the mask.
+    void ReplaceChunkFixtures(entt::entity terrainEntity, int chunkIndex, std::vector<TerrainContour>& contours);
+    void WakeUpBodiesInRect(const TerrainComponent& terrain, const SDL_Rect& maskRect);
+    // Stamp the pixels of the debris to the terrain mask under it. Otherwise make the debris a static tile.
+    void SettleDebrisEntity(entt::entity debrisEntity);
+    std::vector<DebrisCell> CollectDebrisCells(const TerrainComponent& terrain, const glm::vec2& centerPixels, float radiusPixels);
+};
@@ -13,8 +13,8 @@ TurretGameLogicSystem::TurretGameLogicSystem(entt::registry& registry, GameObjec
 
 void TurretGameLogicSystem::Update()
 {
-    registry.view<TurretComponent, PhysicsComponent, FireRateComponent, AnimationComponent>().each(
-        [this]([[maybe_unused]] entt::entity entity, TurretComponent& turret, PhysicsComponent& physics, FireRateComponent& fireRate, AnimationComponent& animation)
+    registry.view<TurretComponent, TransformComponent, FireRateComponent, AnimationComponent>().each(
+        [this]([[maybe_unused]] entt::entity entity, TurretComponent& turret, const TransformComponent& transform, FireRateComponent& fireRate, AnimationComponent& animation)
         {
             if (!turret.shooting)
                 return;
@@ -22,9 +22,9 @@ void TurretGameLogicSystem::Update()
             if (fireRate.remainingFireRate > 0.0f)
                 return;
 
-            glm::vec2 initialBulletPosWorld = coordinatesTransformer.PhysicsToWorld(physics.bodyRAII->GetBody()->GetPosition());
+            glm::vec2 initialBulletPosWorld = transform.positionWorld;
 
-            float bodyAngle = physics.bodyRAII->GetBody()->GetAngle();
+            float bodyAngle = transform.angle;
             float gunGirection = utils::GetAngleFromDirection(turret.gunGirection);
             gunGirection += utils::Random<float>(-0.5f, 0.5f);
             float bulletAngle = bodyAngle + gunGirection;
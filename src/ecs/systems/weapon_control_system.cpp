@@ -1,6 +1,7 @@
 #include "weapon_control_system.h"
 #include "utils/factories/base_objects_factory.h"
 #include <SDL_rect.h>
+#include <algorithm>
 #include <box2d/b2_body.h>
 #include <box2d/b2_math.h>
 #include <ecs/components/event_components.h>
@@ -8,11 +9,15 @@
 #include <ecs/components/rendering_components.h>
 #include <ecs/components/weapon_components.h>
 #include <entt/entity/fwd.hpp>
+#include <map>
 #include <my_cpp_utils/config.h>
 #include <my_cpp_utils/logger.h>
 #include <my_cpp_utils/math_utils.h>
+#include <set>
+#include <tuple>
 #include <utils/box2d/box2d_body_tuner.h>
 #include <utils/box2d/box2d_glm_operators.h>
+#include <utils/box2d/box2d_spatial_query.h>
 #include <utils/coordinates_transformer.h>
 #include <utils/entt/entt_registry_requests.h>
 #include <utils/entt/entt_registry_wrapper.h>
@@ -24,9 +29,11 @@
 #include <utils/systems/box2d_entt_contact_listener.h>
 
 WeaponControlSystem::WeaponControlSystem(
-    EnttRegistryWrapper& registryWrapper, Box2dEnttContactListener& contactListener, AudioSystem& audioSystem, BaseObjectsFactory& baseObjectsFactory)
+    EnttRegistryWrapper& registryWrapper, Box2dEnttContactListener& contactListener, AudioSystem& audioSystem, BaseObjectsFactory& baseObjectsFactory,
+    TerrainSystem& terrainSystem)
   : registryWrapper(registryWrapper), registry(registryWrapper), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())),
-    contactListener(contactListener), audioSystem(audioSystem), baseObjectsFactory(baseObjectsFactory), coordinatesTransformer(registry), physicsBodyTuner(registry)
+    contactListener(contactListener), audioSystem(audioSystem), baseObjectsFactory(baseObjectsFactory), terrainSystem(terrainSystem), coordinatesTransformer(registry),
+    physicsBodyTuner(registry)
 {
     SubscribeToContactEvents();
 }
@@ -34,84 +41,107 @@ WeaponControlSystem::WeaponControlSystem(
 void WeaponControlSystem::Update(float deltaTime)
 {
     CheckTimerExplosionEntities();
-    ProcessEntitiesQueues();
     UpdateFireRateComponents(deltaTime);
 }
 
 void WeaponControlSystem::SubscribeToContactEvents()
 {
-    contactListener.SubscribeContact(
+    contactListener.SubscribeContact<ExplosionOnContactComponent, PhysicsComponent>(
         Box2dEnttContactListener::ContactType::Begin,
-        [this](const Box2dEnttContactListener::ContactInfo& contactInfo)
+        [this](std::span<const Box2dEnttContactListener::ContactInfo> contactInfos) { HandleExplosionContacts(contactInfos); });
+
+    contactListener.SubscribeContact<HitCountComponent>(
+        Box2dEnttContactListener::ContactType::Begin,
+        [this](std::span<const Box2dEnttContactListener::ContactInfo> contactInfos) { HandleHitCountContacts(contactInfos); });
+}
+
+void WeaponControlSystem::HandleExplosionContacts(std::span<const Box2dEnttContactListener::ContactInfo> contactInfos)
+{
+    // One entity may have many contacts during the step. It explodes once with the contact point of the last one.
+    std::map<entt::entity, ExplosionEntityWithContactPoint> explosions;
+    std::set<entt::entity> stickedEntities;
+
+    for (const auto& contactInfo : contactInfos)
+    {
+        if (!registry.valid(contactInfo.entityA) || !registry.valid(contactInfo.entityB))
+            continue;
+
+        // Check if any entity is ExplostionParticlesComponent. If so, then do not trigger the explosion.
+        if (registry.any_of<ExplostionParticlesComponent>(contactInfo.entityA) || registry.any_of<ExplostionParticlesComponent>(contactInfo.entityB))
+            continue;
+
+        for (const auto& explosionEntity : {contactInfo.entityA, contactInfo.entityB})
         {
-            // Check if any entity is ExplostionParticlesComponent. If so, then do not trigger the explosion.
-            if (registry.any_of<ExplostionParticlesComponent>(contactInfo.entityA) || registry.any_of<ExplostionParticlesComponent>(contactInfo.entityB))
-                return;
+            // If the entity contains the ExplosionOnContactComponent.
+            if (!registry.all_of<ExplosionOnContactComponent, PhysicsComponent>(explosionEntity))
+                continue;
 
-            for (const auto& explosionEntity : {contactInfo.entityA, contactInfo.entityB})
+            // If the entity contains the StickyComponent, check if it is sticked.
+            bool shouldExplode = true;
+            if (registry.all_of<StickyComponent>(explosionEntity))
             {
-                // If the entity contains the ExplosionOnContactComponent.
-                if (!registry.all_of<ExplosionOnContactComponent, PhysicsComponent>(explosionEntity))
-                    continue;
+                auto& stickFlagComponent = registry.get<StickyComponent>(explosionEntity);
 
-                // If the entity contains the StickyComponent, check if it is sticked.
-                bool shouldExplode = true;
-                if (registry.all_of<StickyComponent>(explosionEntity))
+                if (!stickFlagComponent.isSticked)
                 {
-                    auto& stickFlagComponent = registry.get<StickyComponent>(explosionEntity);
-
-                    if (!stickFlagComponent.isSticked)
-                    {
-                        // If it is in flight, then the explosion should not be triggered.
-                        // Body should become static and explosion should be triggered on the next contact.
-                        becomeStaticEntitiesQueue.insert(explosionEntity);
-                        stickFlagComponent.isSticked = true;
-                        shouldExplode = false;
-                    }
-                    else
-                    {
-                        // If it is sticked (installed), then the explosion should be triggered.
-                        shouldExplode = true;
-                    }
+                    // If it is in flight, then the explosion should not be triggered.
+                    // Body should become static and explosion should be triggered on the next contact.
+                    stickedEntities.insert(explosionEntity);
+                    stickFlagComponent.isSticked = true;
+                    shouldExplode = false;
                 }
-
-                if (shouldExplode)
+                else
                 {
-                    // Calculate the contact point in the physics world.
-                    auto physicsComponent = registry.get<PhysicsComponent>(explosionEntity);
-                    std::optional<b2Vec2> contactPointPhysics;
-                    if (contactInfo.contact->GetManifold()->pointCount > 0)
-                    {
-                        auto localPoint = contactInfo.contact->GetManifold()->points[0].localPoint;
-                        contactPointPhysics = physicsComponent.bodyRAII->GetBody()->GetWorldPoint(localPoint);
-                        auto contactPointWorld = coordinatesTransformer.PhysicsToWorld(contactPointPhysics.value());
-                        MY_LOG(debug, "[ExplosionOnContact] Contact Point World: {}", contactPointWorld);
-                    }
-
-                    AppendToExplosionQueue({explosionEntity, contactPointPhysics});
+                    // If it is sticked (installed), then the explosion should be triggered.
+                    shouldExplode = true;
                 }
             }
-        });
 
-    contactListener.SubscribeContact(
-        Box2dEnttContactListener::ContactType::Begin,
-        [this](const Box2dEnttContactListener::ContactInfo& contactInfo)
-        {
-            for (const auto& entity : {contactInfo.entityA, contactInfo.entityB})
+            if (shouldExplode)
             {
-                auto hitCountComponent = registry.try_get<HitCountComponent>(entity);
-                if (!hitCountComponent)
-                    return;
+                if (contactInfo.pointPhysics)
+                {
+                    auto contactPointWorld = coordinatesTransformer.PhysicsToWorld(contactInfo.pointPhysics.value());
+                    MY_LOG(debug, "[ExplosionOnContact] Contact Point World: {}", contactPointWorld);
+                }
 
-                hitCountComponent->hitCount++;
+                explosions[explosionEntity] = {explosionEntity, contactInfo.pointPhysics};
             }
-        });
+        }
+    }
+
+    for (auto entity : stickedEntities)
+    {
+        physicsBodyTuner.ApplyOption(entity, Box2dBodyOptions::MovementPolicy::Manual);
+    }
+
+    for (const auto& [entity, entityWithContactPoint] : explosions)
+    {
+        // If the entity just hit the wall during this step, it becomes static. Explosion should be on the next contact.
+        // Entity may be already destroyed by the explosion of the previous entity.
+        if (!stickedEntities.contains(entity) && registry.valid(entity))
+        {
+            DoExplosion(entityWithContactPoint);
+        }
+    }
 }
 
-// Not allowed to update Box2D object in the contact listener. Because Box2D is in simulation step.
-void WeaponControlSystem::AppendToExplosionQueue(const ExplosionEntityWithContactPoint& explosionEntityWithContactPoint)
+void WeaponControlSystem::HandleHitCountContacts(std::span<const Box2dEnttContactListener::ContactInfo> contactInfos)
 {
-    explosionEntitiesQueue[explosionEntityWithContactPoint.explosionEntity] = explosionEntityWithContactPoint;
+    for (const auto& contactInfo : contactInfos)
+    {
+        for (const auto& entity : {contactInfo.entityA, contactInfo.entityB})
+        {
+            if (!registry.valid(entity))
+                continue;
+
+            auto hitCountComponent = registry.try_get<HitCountComponent>(entity);
+            if (!hitCountComponent)
+                continue;
+
+            hitCountComponent->hitCount++;
+        }
+    }
 }
 
 void WeaponControlSystem::CheckTimerExplosionEntities()
@@ -132,15 +162,15 @@ void WeaponControlSystem::DoExplosion(const ExplosionEntityWithContactPoint& exp
     auto& explosionEntity = explosionEntityWithContactPoint.explosionEntity;
 
     auto damageComponent = registry.try_get<DamageComponent>(explosionEntity);
-    auto physicsInfo = registry.try_get<PhysicsComponent>(explosionEntity);
+    auto transform = registry.try_get<TransformComponent>(explosionEntity);
 
-    if (!damageComponent || !physicsInfo)
+    if (!damageComponent || !transform)
         return;
 
     // Calculate the contact point in the physics world.
-    b2Vec2 contactPointPhysics = explosionEntityWithContactPoint.contactPointPhysics.value_or(physicsInfo->bodyRAII->GetBody()->GetPosition());
+    b2Vec2 contactPointPhysics = explosionEntityWithContactPoint.contactPointPhysics.value_or(transform->positionPhysics);
     if (utils::GetConfig<bool, "WeaponControlSystem.explosionPointAlwaysAtCenterOfExplosionEntity">())
-        contactPointPhysics = physicsInfo->bodyRAII->GetBody()->GetPosition();
+        contactPointPhysics = transform->positionPhysics;
 
     if (utils::GetConfig<bool, "WeaponControlSystem.debugDrawExplosionInitiator">())
     {
@@ -155,29 +185,28 @@ void WeaponControlSystem::DoExplosion(const ExplosionEntityWithContactPoint& exp
     // Get all physical bodies in the explosion radius.
     float damageRadius = damageComponent->radius * 1.5; // TODO0: hack. Need to calculate it based on the texture size.
                                                         // Because position is calculated from the center of the texture.
-    std::vector<entt::entity> allOriginalBodiesInRadius = request::FindEntitiesWithAllComponentsInRadius(registry, contactPointPhysics, damageRadius);
-    MY_LOG(debug, "[DoExplosion] FindEntitiesInRadius count {}", allOriginalBodiesInRadius.size());
+    auto& cellSizeForMicroDistruction = utils::GetConfig<int, "WeaponControlSystem.cellSizeForMicroDistruction">();
+    std::vector<entt::entity> allOriginalBodiesInRadius = FindEntitiesHitByExplosion(contactPointPhysics, damageRadius, cellSizeForMicroDistruction);
+    MY_LOG(debug, "[DoExplosion] FindEntitiesHitByExplosion count {}", allOriginalBodiesInRadius.size());
 
     // Get destructible objects.
     auto destructibleOriginalBodies = request::GetEntitiesWithAllComponents<DestructibleComponent>(registry, allOriginalBodiesInRadius);
     destructibleOriginalBodies = request::RemoveEntitiesWithAllComponents<ExplostionParticlesComponent>(registry, destructibleOriginalBodies);
     MY_LOG(debug, "[DoExplosion] Getting destructible objects. Count {}", destructibleOriginalBodies.size());
 
-    // Split original objects to micro objects.
-    auto& cellSizeForMicroDistruction = utils::GetConfig<int, "WeaponControlSystem.cellSizeForMicroDistruction">();
+    // Split original objects to micro objects. Micro objects in the explosion radius are not spawned.
     SDL_Point cellSize = {cellSizeForMicroDistruction, cellSizeForMicroDistruction};
-    auto newMicroBodies = baseObjectsFactory.SpawnSplittedPhysicalEnteties(destructibleOriginalBodies, cellSize);
+    glm::vec2 contactPointWorld = coordinatesTransformer.PhysicsToWorld(contactPointPhysics);
+    float damageRadiusWorld = coordinatesTransformer.PhysicsToWorld(damageRadius);
+    auto newMicroBodies = baseObjectsFactory.SpawnSplittedPhysicalEnteties(destructibleOriginalBodies, cellSize, contactPointWorld, damageRadiusWorld);
     MY_LOG(debug, "[DoExplosion] Spawn micro splittedEntities count {}", newMicroBodies.size());
 
-    // Get micro objects in the explosion radius.
-    auto newMicroBodiesToDestroy = request::FilterEntitiesWithAllComponentsInRadius(registry, newMicroBodies, contactPointPhysics, damageRadius);
-
-    // Destroy micro objects in the explosion radius.
-    MY_LOG(debug, "[DoExplosion] Destroing {} micro objects", newMicroBodiesToDestroy.size());
-    for (auto& entity : newMicroBodiesToDestroy)
-        registryWrapper.Destroy(entity);
+    // Carve the bitmap terrain. Debris are the carved pixels which fly away like the original tiles.
+    bool keepTilesAliveOnExplosion = utils::GetConfig<bool, "WeaponControlSystem.keepTilesAliveOnExplosion">();
+    auto terrainDebris = terrainSystem.CarveCircle(contactPointPhysics, damageRadius, keepTilesAliveOnExplosion);
+    destructibleOriginalBodies.insert(destructibleOriginalBodies.end(), terrainDebris.begin(), terrainDebris.end());
 
-    if (utils::GetConfig<bool, "WeaponControlSystem.keepTilesAliveOnExplosion">())
+    if (keepTilesAliveOnExplosion)
     {
         // Apply force to micro objects from the explosion center.
         for (auto& entity : destructibleOriginalBodies)
@@ -193,11 +222,10 @@ void WeaponControlSystem::DoExplosion(const ExplosionEntityWithContactPoint& exp
             physicsBodyTuner.ApplyOption(entity, Box2dBodyOptions::MovementPolicy::Box2dPhysics);
             // How to read: "I have own collision category Default and I want collide with Default".
             physicsBodyTuner.ApplyOption(entity, {CollisionFlags::Default, CollisionFlags::Default});
-            registry.emplace_or_replace<ExplostionParticlesComponent>(entity);
+            registry.emplace_or_replace<ExplostionParticlesComponent>(entity, 0.0f, explosionParticlesSpawnCounter++);
 
-            auto& physicsComponent = registry.get<PhysicsComponent>(entity);
-            auto body = physicsComponent.bodyRAII->GetBody();
-            auto bodyPos = body->GetPosition();
+            auto body = registry.get<PhysicsComponent>(entity).body;
+            auto bodyPos = registry.get<TransformComponent>(entity).positionPhysics;
 
             // Apply force to the body.
             auto vec = bodyPos - contactPointPhysics;
@@ -215,6 +243,8 @@ void WeaponControlSystem::DoExplosion(const ExplosionEntityWithContactPoint& exp
         }
     }
 
+    EvictExplosionParticlesOverBudget();
+
     if (utils::GetConfig<bool, "WeaponControlSystem.createSyntheticExplosionFragments">())
     {
         glm::vec2 fragmentsCenterWorld = coordinatesTransformer.PhysicsToWorld(contactPointPhysics);
@@ -229,26 +259,65 @@ void WeaponControlSystem::DoExplosion(const ExplosionEntityWithContactPoint& exp
     audioSystem.PlaySoundEffect("explosion");
 }
 
-void WeaponControlSystem::ProcessEntitiesQueues()
+std::vector<entt::entity> WeaponControlSystem::FindEntitiesHitByExplosion(const b2Vec2& centerPhysics, float radiusPhysics, int cellSizeWorld)
 {
-    for (auto entity : becomeStaticEntitiesQueue)
+    std::vector<entt::entity> result;
+
+    // Broadphase reports the bodies by the fixtures, so the big tiles with the center outside of the circle are found too.
+    for (auto entity : utils::QueryEntitiesInBox(registry, centerPhysics, radiusPhysics))
     {
-        physicsBodyTuner.ApplyOption(entity, Box2dBodyOptions::MovementPolicy::Manual);
+        auto transform = registry.try_get<TransformComponent>(entity);
+        if (!transform)
+            continue;
+
+        float halfDiagonalPhysics = 0.0f;
+        auto tile = registry.try_get<TileComponent>(entity);
+        if (tile && tile->textureRect.w > cellSizeWorld && tile->textureRect.h > cellSizeWorld)
+            halfDiagonalPhysics = coordinatesTransformer.WorldToPhysics(glm::length(tile->sizeWorld) / 2.0f);
+
+        if (b2Distance(centerPhysics, transform->positionPhysics) - halfDiagonalPhysics < radiusPhysics)
+            result.push_back(entity);
     }
 
-    for (const auto& [entity, entotyWithCollisionPoint] : explosionEntitiesQueue)
+    return result;
+}
+
+void WeaponControlSystem::EvictExplosionParticlesOverBudget()
+{
+    auto& maxExplosionParticles = utils::GetConfig<size_t, "WeaponControlSystem.maxExplosionParticles">();
+    auto particles = registry.view<ExplostionParticlesComponent, TransformComponent>();
+
+    // Particles outside of the camera view are evicted first. Then the oldest ones.
+    const auto& wOpt = gameState.windowOptions;
+    glm::vec2 halfViewWorld = wOpt.windowSize / (2.0f * wOpt.cameraScale);
+    struct EvictionCandidate
     {
-        // Here was a bug. If the entity is already in the becomeStaticEntitiesQueue, then the explosion should not be
-        // triggered. This means that the entity just hit the wall and should become static. Explosion should be on the
-        // next contact.
-        if (!becomeStaticEntitiesQueue.contains(entotyWithCollisionPoint.explosionEntity))
-        {
-            DoExplosion(entotyWithCollisionPoint);
-        }
+        bool isVisible;
+        size_t spawnOrder;
+        entt::entity entity;
+    };
+    std::vector<EvictionCandidate> candidates;
+    for (auto entity : particles)
+    {
+        auto& particlesComponent = particles.get<ExplostionParticlesComponent>(entity);
+        glm::vec2 posWorld = particles.get<TransformComponent>(entity).positionWorld;
+        glm::vec2 distanceToCamera = glm::abs(posWorld - wOpt.cameraCenterSdl);
+        bool isVisible = distanceToCamera.x <= halfViewWorld.x && distanceToCamera.y <= halfViewWorld.y;
+        candidates.push_back({isVisible, particlesComponent.spawnOrder, entity});
     }
 
-    explosionEntitiesQueue.clear();
-    becomeStaticEntitiesQueue.clear();
+    if (candidates.size() <= maxExplosionParticles)
+        return;
+
+    size_t evictedNumber = candidates.size() - maxExplosionParticles;
+    std::nth_element(
+        candidates.begin(), candidates.begin() + evictedNumber, candidates.end(),
+        [](const EvictionCandidate& a, const EvictionCandidate& b) { return std::tie(a.isVisible, a.spawnOrder) < std::tie(b.isVisible, b.spawnOrder); });
+
+    for (size_t i = 0; i < evictedNumber; ++i)
+        registryWrapper.Destroy(candidates[i].entity);
+
+    MY_LOG(debug, "[WeaponControlSystem] Evicted {} explosion particles over the budget {}", evictedNumber, maxExplosionParticles);
 }
 
 void WeaponControlSystem::UpdateFireRateComponents(float deltaTime)
@@ -1,5 +1,6 @@
 #pragma once
 #include "utils/factories/base_objects_factory.h"
+#include <ecs/systems/terrain_system.h>
 #include <entt/entt.hpp>
 #include <utils/box2d/box2d_body_tuner.h>
 #include <utils/coordinates_transformer.h>
@@ -23,20 +24,28 @@ class WeaponControlSystem
     Box2dEnttContactListener& contactListener;
     AudioSystem& audioSystem;
     BaseObjectsFactory& baseObjectsFactory;
+    TerrainSystem& terrainSystem;
     CoordinatesTransformer coordinatesTransformer;
     Box2dBodyTuner physicsBodyTuner;
-private: /////////////// Queues for entities that should be processed when Box2D calc step has complete. /////////////
-    std::map<entt::entity, ExplosionEntityWithContactPoint> explosionEntitiesQueue;
-    std::set<entt::entity> becomeStaticEntitiesQueue;
+private:
+    size_t explosionParticlesSpawnCounter = 0; // Used to find the oldest explosion particles.
 public:
-    WeaponControlSystem(EnttRegistryWrapper& registryWrapper, Box2dEnttContactListener& contactListener, AudioSystem& audioSystem, BaseObjectsFactory& baseObjectsFactory);
+    WeaponControlSystem(
+        EnttRegistryWrapper& registryWrapper, Box2dEnttContactListener& contactListener, AudioSystem& audioSystem, BaseObjectsFactory& baseObjectsFactory,
+        TerrainSystem& terrainSystem);
     void Update(float deltaTime);
 private:
     void SubscribeToContactEvents();
-    void AppendToExplosionQueue(const ExplosionEntityWithContactPoint& explosionEntityWithContactPoint);
+    // Stick or explode the entities with ExplosionOnContactComponent. Called with the contacts of one physics step.
+    void HandleExplosionContacts(std::span<const Box2dEnttContactListener::ContactInfo> contactInfos);
+    void HandleHitCountContacts(std::span<const Box2dEnttContactListener::ContactInfo> contactInfos);
 private:
     void CheckTimerExplosionEntities();
-    void ProcessEntitiesQueues();
     void DoExplosion(const ExplosionEntityWithContactPoint& explosionEntityWithContactPoint);
+    // Entities overlapping the explosion circle. Tiles bigger than the cell are checked by the circle around the tile,
+    // because they are splitted and only the part inside the hole is removed. Smaller tiles are checked by the center.
+    std::vector<entt::entity> FindEntitiesHitByExplosion(const b2Vec2& centerPhysics, float radiusPhysics, int cellSizeWorld);
+    // Destroy explosion particles over `WeaponControlSystem.maxExplosionParticles`.
+    void EvictExplosionParticlesOverBudget();
     void UpdateFireRateComponents(float deltaTime);
 };
\ No newline at end of file
@@ -10,13 +10,18 @@
 #include <ecs/systems/portals_game_logic_system.h>
 #include <ecs/systems/render_hud_systems.h>
 #include <ecs/systems/render_world_system.h>
+#include <ecs/systems/terrain_system.h>
 #include <ecs/systems/timers_control_system.h>
 #include <ecs/systems/turret_game_logic_system.h>
 #include <ecs/systems/weapon_control_system.h>
+#include <charconv>
+#include <chrono>
 #include <iostream>
 #include <magic_enum.hpp>
 #include <my_cpp_utils/config.h>
 #include <my_cpp_utils/json_utils.h>
+#include <optional>
+#include <utils/box2d/box2d_body_ownership.h>
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/factories/components_factory.h>
 #include <utils/factories/game_objects_factory.h>
@@ -42,7 +47,77 @@ void mainLoopForEmscripten()
     globalMainLoopLambda();
 }
 
-int main([[maybe_unused]] int argc, char* args[])
+namespace
+{
+
+enum class RenderMode
+{
+    Window,
+    // Run the simulation without the window, the renderer, ImGui and the audio. Textures are not created.
+    // Every frame simulates `1 / main.fps` seconds regardless of the real time. Used for soak tests and profiling.
+    Headless,
+};
+
+enum class FrameRateMode
+{
+    Capped, // Frame delay up to `main.fps` and vsync.
+    Uncapped, // Run as fast as possible. No frame delay and no vsync.
+};
+
+enum class RunMode
+{
+    Game,
+    // Load the level parsed and then restored from the baked level, compare them and quit. Used by ctest with `--headless`.
+    CheckLevelBake,
+};
+
+// Options of the launch. Parsed from the command line arguments.
+struct LaunchOptions
+{
+    RenderMode renderMode = RenderMode::Window;
+    FrameRateMode frameRateMode = FrameRateMode::Capped;
+    RunMode runMode = RunMode::Game;
+    std::optional<size_t> maxFrames; // Quit after the number of frames.
+    std::optional<size_t> workerThreads; // Overrides `TaskScheduler.workerThreads`. Used to compare the threading on the same scenario.
+};
+
+size_t ParseCount(std::string_view value, std::string_view argName)
+{
+    size_t count = 0;
+    auto [ptr, errorCode] = std::from_chars(value.data(), value.data() + value.size(), count);
+    if (errorCode != std::errc() || ptr != value.data() + value.size())
+        throw std::runtime_error(MY_FMT("Invalid value of {}: {}", argName, value));
+    return count;
+}
+
+LaunchOptions ParseLaunchOptions(int argc, char* args[])
+{
+    LaunchOptions launchOptions;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = args[i];
+        if (arg == "--headless")
+            launchOptions.renderMode = RenderMode::Headless;
+        else if (arg == "--uncapped")
+            launchOptions.frameRateMode = FrameRateMode::Uncapped;
+        else if (arg == "--check-level-bake")
+            launchOptions.runMode = RunMode::CheckLevelBake;
+        else if (arg == "--frames" && i + 1 < argc)
+            launchOptions.maxFrames = ParseCount(args[++i], arg);
+        else if (arg == "--workers" && i + 1 < argc)
+            launchOptions.workerThreads = ParseCount(args[++i], arg);
+        else
+            throw std::runtime_error(MY_FMT(
+                "Unknown command line argument: {}. Usage: [--headless] [--uncapped] [--check-level-bake] [--frames N] [--workers N]. "
+                "--workers sets the threads of the terrain contour extraction, the physics step is single-threaded",
+                arg));
+    }
+    return launchOptions;
+}
+
+} // namespace
+
+int main(int argc, char* args[])
 {
     try
     {
@@ -72,25 +147,52 @@ int main([[maybe_unused]] int argc, char* args[])
         MY_LOG(info, "Current directory set to: {}", execDir);
         MY_LOG(info, "Config file loaded: {}", configFilePath.string());
 
+        LaunchOptions launchOptions = ParseLaunchOptions(argc, args);
+        MY_LOG(
+            info, "Launch options: renderMode={}, frameRateMode={}, runMode={}", magic_enum::enum_name(launchOptions.renderMode),
+            magic_enum::enum_name(launchOptions.frameRateMode), magic_enum::enum_name(launchOptions.runMode));
+        bool isHeadless = launchOptions.renderMode == RenderMode::Headless;
+
         // Create an EnTT registry.
         entt::registry registry;
         EnttRegistryWrapper registryWrapper(registry);
+        utils::ConnectBox2dBodyOwnership(registry);
 
         // Create a game state entity.
         auto& gameOptions = registry.emplace<GameOptions>(registryWrapper.Create("GameOptions"), utils::GetConfig<GameOptions, "GameOptions">());
 
-        // Initialize SDL, create a window and a renderer. Initialize ImGui.
-        SDLInitializerRAII sdlInitializer(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
-        SDLAudioInitializerRAII sdlAudioInitializer;
-        SDLWindowRAII window("Wofares Game Engine created by marleeeeeey", gameOptions.windowOptions.windowSize);
-        SDLRendererRAII renderer(window, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-        ImGuiSDLRAII imguiSDL(window, renderer);
+        // Threads are not available in the web build.
+        size_t workerThreads = launchOptions.workerThreads.value_or(utils::GetConfig<size_t, "TaskScheduler.workerThreads">());
+#ifdef __EMSCRIPTEN__
+        workerThreads = 0;
+#endif // __EMSCRIPTEN__
+        gameOptions.taskScheduler = std::make_shared<TaskScheduler>(workerThreads);
+        MY_LOG(info, "Task scheduler worker threads: {}", workerThreads);
+
+        // Initialize SDL, create a window and a renderer. Initialize ImGui. Nothing of that is created in the headless mode.
+        SDLInitializerRAII sdlInitializer(isHeadless ? SDL_INIT_TIMER | SDL_INIT_EVENTS : SDL_INIT_VIDEO | SDL_INIT_AUDIO);
+        std::optional<SDLAudioInitializerRAII> sdlAudioInitializer;
+        std::optional<SDLWindowRAII> window;
+        std::optional<SDLRendererRAII> renderer;
+        std::optional<ImGuiSDLRAII> imguiSDL;
+        SDL_Renderer* sdlRenderer = nullptr;
+        if (!isHeadless)
+        {
+            Uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+            if (launchOptions.frameRateMode == FrameRateMode::Capped)
+                rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+            sdlAudioInitializer.emplace();
+            window.emplace("Wofares Game Engine created by marleeeeeey", gameOptions.windowOptions.windowSize);
+            renderer.emplace(*window, rendererFlags);
+            imguiSDL.emplace(*window, *renderer);
+            sdlRenderer = *renderer;
+        }
 
         std::filesystem::path assetsSettingsFilePath = "assets/assets_settings.json";
         auto assetsSettingsJson = utils::LoadJsonFromFile(assetsSettingsFilePath);
         MY_LOG(info, "Assets settings loaded: {}", assetsSettingsFilePath.string());
-        ResourceManager resourceManager(renderer, assetsSettingsJson);
-        AudioSystem audioSystem(resourceManager);
+        ResourceManager resourceManager(sdlRenderer, assetsSettingsJson);
+        AudioSystem audioSystem(resourceManager, isHeadless ? AudioSystem::Mode::Disabled : AudioSystem::Mode::Enabled);
         audioSystem.PlayMusic("background_music");
 
         ComponentsFactory componentsFactory(resourceManager);
@@ -99,7 +201,8 @@ int main([[maybe_unused]] int argc, char* args[])
 
         // Create a weapon control system and subscribe it to the contact listener.
         Box2dEnttContactListener contactListener(registryWrapper);
-        WeaponControlSystem weaponControlSystem(registryWrapper, contactListener, audioSystem, baseObjectsFactory);
+        TerrainSystem terrainSystem(registryWrapper, baseObjectsFactory);
+        WeaponControlSystem weaponControlSystem(registryWrapper, contactListener, audioSystem, baseObjectsFactory, terrainSystem);
 
         // Create an input event manager and an event queue system.
         InputEventManager inputEventManager;
@@ -111,17 +214,24 @@ int main([[maybe_unused]] int argc, char* args[])
         GameStateControlSystem gameStateControlSystem(registryWrapper, inputEventManager);
 
         // Create a systems with no input events.
-        SdlPrimitivesRenderer primitivesRenderer(registryWrapper, renderer);
-        PhysicsSystem physicsSystem(registryWrapper);
-        RenderWorldSystem RenderWorldSystem(registryWrapper, renderer, resourceManager, primitivesRenderer);
-        RenderHUDSystem RenderHUDSystem(registryWrapper, renderer, assetsSettingsJson);
+        SdlPrimitivesRenderer primitivesRenderer(registryWrapper, sdlRenderer);
+        PhysicsSystem physicsSystem(registryWrapper, contactListener);
+        RenderWorldSystem RenderWorldSystem(registryWrapper, sdlRenderer, resourceManager, primitivesRenderer);
+        RenderHUDSystem RenderHUDSystem(registryWrapper, sdlRenderer, assetsSettingsJson);
 
         // Auxiliary systems.
-        ScreenModeControlSystem screenModeControlSystem(inputEventManager, window);
+        std::optional<ScreenModeControlSystem> screenModeControlSystem;
+        if (window)
+            screenModeControlSystem.emplace(inputEventManager, *window);
         TimersControlSystem timersControlSystem(registryWrapper);
 
         // Load the map.
         MapLoaderSystem mapLoaderSystem(registryWrapper, resourceManager, contactListener, gameObjectsFactory, baseObjectsFactory);
+        if (launchOptions.runMode == RunMode::CheckLevelBake)
+        {
+            mapLoaderSystem.CheckLevelBakeRoundTrip(resourceManager.GetTiledLevel(gameOptions.levelOptions.mapName));
+            return 0;
+        }
 
         CoordinatesTransformer coordinatesTransformer(registryWrapper);
 
@@ -135,23 +245,29 @@ int main([[maybe_unused]] int argc, char* args[])
 
         // Set the main loop lambda.
         Uint32 lastTick = SDL_GetTicks();
+        size_t frameCounter = 0;
+        auto runStartTime = std::chrono::steady_clock::now();
         globalMainLoopLambda = [&]()
         {
-            // Calculate delta time.
+            // Calculate delta time. Headless mode simulates the time with the constant frame rate.
             Uint32 frameStart = SDL_GetTicks();
             float deltaTime = static_cast<float>(frameStart - lastTick) / 1000.0f;
+            if (isHeadless)
+                deltaTime = 1.0f / utils::GetConfig<unsigned, "main.fps">();
             lastTick = frameStart;
 
             if (gameOptions.controlOptions.reloadMap)
             {
                 auto level = resourceManager.GetTiledLevel(gameOptions.levelOptions.mapName);
                 mapLoaderSystem.LoadMap(level);
+                terrainSystem.Update();
                 gameOptions.controlOptions.reloadMap = false;
                 inputEventManager.Reset();
             }
 
-            // Handle input events.
-            eventQueueSystem.Update(deltaTime);
+            // Handle input events. There is no input in the headless mode.
+            if (!isHeadless)
+                eventQueueSystem.Update(deltaTime);
 
             // Auxiliary systems.
             timersControlSystem.Update(deltaTime);
@@ -163,6 +279,8 @@ int main([[maybe_unused]] int argc, char* args[])
             portalsGameLogicSystem.Update(deltaTime);
             turretGameLogicSystem.Update();
             weaponControlSystem.Update(deltaTime);
+            terrainSystem.SettleDebris(deltaTime);
+            terrainSystem.Update();
             cameraControlSystem.Update(deltaTime);
 
             // Update animation.
@@ -171,16 +289,23 @@ int main([[maybe_unused]] int argc, char* args[])
             debugSystem.Update();
 
             // Render the scene and the HUD.
-            imguiSDL.startFrame();
-            RenderWorldSystem.Render();
-            RenderHUDSystem.Render();
-            imguiSDL.finishFrame();
+            if (imguiSDL)
+            {
+                imguiSDL->startFrame();
+                RenderWorldSystem.Render();
+                RenderHUDSystem.Render();
+                imguiSDL->finishFrame();
+            }
+
+            ++frameCounter;
+            if (launchOptions.maxFrames && frameCounter >= *launchOptions.maxFrames)
+                gameOptions.controlOptions.quit = true;
 
 #ifndef __EMSCRIPTEN__
             // Cap the frame rate.
             Uint32 frameTimeMs = SDL_GetTicks() - frameStart;
             const Uint32 frameDelayMs = 1000 / utils::GetConfig<unsigned, "main.fps">();
-            if (frameDelayMs > frameTimeMs)
+            if (launchOptions.frameRateMode == FrameRateMode::Capped && frameDelayMs > frameTimeMs)
             {
                 SDL_Delay(frameDelayMs - frameTimeMs);
             }
@@ -199,6 +324,13 @@ int main([[maybe_unused]] int argc, char* args[])
         }
 #endif // __EMSCRIPTEN__
 
+        std::chrono::duration<double, std::milli> runDuration = std::chrono::steady_clock::now() - runStartTime;
+        if (frameCounter > 0)
+            MY_LOG(info, "Frames: {}, average frame time: {:.3f} ms", frameCounter, runDuration.count() / frameCounter);
+        if (gameOptions.bodyPool)
+            gameOptions.bodyPool->LogStats();
+        terrainSystem.LogStats();
+
         registryWrapper.LogAllEntitiesByTheirNames();
     }
     catch (const std::runtime_error& e)
@@ -16,6 +16,7 @@ struct Box2dBodyOptions
         Box,
         Capsule,
         Circle,
+        None, // No fixtures are created by the tuner. Fixtures are managed by the owner of the body (e.g. terrain).
     } shape = Shape::Box;
 
     enum class Sensor
@@ -0,0 +1,32 @@
+#include "box2d_body_ownership.h"
+#include <ecs/components/physics_components.h>
+#include <utils/game_options.h>
+
+namespace
+{
+
+void ReleasePhysicsBody(entt::registry& registry, entt::entity entity)
+{
+    const auto& physicsComponent = registry.get<PhysicsComponent>(entity);
+    if (!physicsComponent.body)
+        return;
+
+    auto& gameState = registry.get<GameOptions>(registry.view<GameOptions>().front());
+    auto poolKey = Box2dBodyPool::MakeKey(physicsComponent.options);
+    if (gameState.bodyPool && poolKey)
+        gameState.bodyPool->Release(*poolKey, physicsComponent.body);
+    else
+        gameState.physicsWorld->DestroyBody(physicsComponent.body);
+}
+
+} // namespace
+
+namespace utils
+{
+
+void ConnectBox2dBodyOwnership(entt::registry& registry)
+{
+    registry.on_destroy<PhysicsComponent>().connect<&ReleasePhysicsBody>();
+}
+
+} // namespace utils
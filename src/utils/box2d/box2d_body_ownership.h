@@ -0,0 +1,12 @@
+#pragma once
+#include <entt/entt.hpp>
+
+namespace utils
+{
+
+// Bodies of PhysicsComponent are owned by the registry. When the component is removed (or its entity is destroyed)
+// the body is returned to GameOptions::bodyPool or destroyed in GameOptions::physicsWorld.
+// Must be called once right after the registry is created.
+void ConnectBox2dBodyOwnership(entt::registry& registry);
+
+} // namespace utils
@@ -0,0 +1,72 @@
+#include "box2d_body_pool.h"
+#include <my_cpp_utils/config.h>
+#include <stdexcept>
+#include <tuple>
+#include <utils/logger.h>
+
+bool Box2dBodyPool::Key::operator<(const Key& other) const
+{
+    return std::tie(shape, sensor, hitboxSizeWorld.x, hitboxSizeWorld.y) <
+        std::tie(other.shape, other.sensor, other.hitboxSizeWorld.x, other.hitboxSizeWorld.y);
+}
+
+Box2dBodyPool::Box2dBodyPool(std::shared_ptr<b2World> world) : world(world)
+{
+    if (!world)
+        throw std::runtime_error("[Box2dBodyPool] b2World is nullptr");
+}
+
+Box2dBodyPool::~Box2dBodyPool()
+{
+    for (auto& [key, bodies] : pooledBodiesByKey)
+        for (auto body : bodies)
+            world->DestroyBody(body);
+}
+
+std::optional<Box2dBodyPool::Key> Box2dBodyPool::MakeKey(const Box2dBodyOptions& options)
+{
+    if (options.shape == Box2dBodyOptions::Shape::None)
+        return std::nullopt;
+
+    return Key{options.shape, options.sensor, options.hitbox.sizeWorld};
+}
+
+b2Body* Box2dBodyPool::Acquire(const Key& key)
+{
+    auto it = pooledBodiesByKey.find(key);
+    if (it == pooledBodiesByKey.end() || it->second.empty())
+    {
+        stats.misses++;
+        return nullptr;
+    }
+
+    b2Body* body = it->second.back();
+    it->second.pop_back();
+    pooledBodiesCount--;
+    stats.hits++;
+    return body;
+}
+
+void Box2dBodyPool::Release(const Key& key, b2Body* body)
+{
+    auto& maxBodiesPerKey = utils::GetConfig<size_t, "Box2dBodyPool.maxBodiesPerKey">();
+    auto& bodies = pooledBodiesByKey[key];
+    if (bodies.size() >= maxBodiesPerKey)
+    {
+        world->DestroyBody(body);
+        stats.dropped++;
+        return;
+    }
+
+    body->SetEnabled(false);
+    bodies.push_back(body);
+    pooledBodiesCount++;
+    stats.released++;
+}
+
+void Box2dBodyPool::LogStats() const
+{
+    MY_LOG(
+        info, "[Box2dBodyPool] {} hits, {} misses, {} released, {} dropped, {} pooled", stats.hits, stats.misses, stats.released, stats.dropped,
+        pooledBodiesCount);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <box2d/box2d.h>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utils/box2d/box2d_body_options.h>
+#include <vector>
+
+// Keeps disabled bodies together with their fixtures to reuse them instead of creating and destroying bodies.
+// Bodies are grouped by the options which define the fixtures: shape, sensor and hitbox size.
+// One pool per Box2D world. Pooled bodies are destroyed with the pool.
+class Box2dBodyPool
+{
+public:
+    struct Key
+    {
+        Box2dBodyOptions::Shape shape;
+        Box2dBodyOptions::Sensor sensor;
+        glm::vec2 hitboxSizeWorld;
+        bool operator<(const Key& other) const;
+    };
+
+    struct Stats
+    {
+        size_t hits = 0; // Bodies taken from the pool.
+        size_t misses = 0; // Bodies created because the pool was empty.
+        size_t released = 0; // Bodies returned to the pool.
+        size_t dropped = 0; // Bodies destroyed because the pool was full.
+    };
+private:
+    std::shared_ptr<b2World> world;
+    std::map<Key, std::vector<b2Body*>> pooledBodiesByKey;
+    size_t pooledBodiesCount = 0;
+    Stats stats;
+public:
+    explicit Box2dBodyPool(std::shared_ptr<b2World> world);
+    ~Box2dBodyPool();
+    Box2dBodyPool(const Box2dBodyPool&) = delete;
+    Box2dBodyPool& operator=(const Box2dBodyPool&) = delete;
+public:
+    // Return std::nullopt for the bodies which fixtures are managed by the owner (Shape::None). They are not pooled.
+    static std::optional<Key> MakeKey(const Box2dBodyOptions& options);
+    // Return the disabled body with the fixtures for the key. Return nullptr if the pool is empty.
+    b2Body* Acquire(const Key& key);
+    // Disable the body and keep it to reuse. Destroy the body if there are `Box2dBodyPool.maxBodiesPerKey` bodies already.
+    void Release(const Key& key, b2Body* body);
+    const Stats& GetStats() const { return stats; }
+    size_t GetPooledBodiesCount() const { return pooledBodiesCount; }
+    void LogStats() const;
+};
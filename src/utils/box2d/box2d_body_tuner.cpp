@@ -9,21 +9,59 @@ Box2dBodyTuner::Box2dBodyTuner(entt::registry& registry)
 
 PhysicsComponent& Box2dBodyTuner::CreatePhysicsComponent(entt::entity entity, const glm::vec2& posWorld, float angle, const Box2dBodyOptions& options)
 {
-    b2Body* body = CreatePhysicsBodyWithNoShape(entity, posWorld);
-    auto box2dObjectRAII = std::make_shared<Box2dObjectRAII>(body, gameState.physicsWorld);
-    PhysicsComponent& physicsComponent = registry.emplace<PhysicsComponent>(entity, box2dObjectRAII, options);
-    body->SetTransform(body->GetPosition(), angle);
-
-    ApplyOption(entity, options.fixture);
-    ApplyOption(entity, options.shape);
-    ApplyOption(entity, options.sensor);
-    ApplyOption(entity, options.dynamic);
-    ApplyOption(entity, options.anglePolicy);
-    ApplyOption(entity, options.collisionPolicy);
-    ApplyOption(entity, options.bulletPolicy);
-    ApplyOption(entity, options.hitbox);
+    return CreatePhysicsComponent(entity, posWorld, angle, CompileBodyOptions(options));
+}
 
-    return physicsComponent;
+void Box2dBodyTuner::CreatePhysicsComponents(std::span<const BodySpawn> spawns, const Box2dBodyOptions& options)
+{
+    if (spawns.empty())
+        return;
+
+    auto compiledBody = CompileBodyOptions(options);
+    for (const auto& spawn : spawns)
+        CreatePhysicsComponent(spawn.entity, spawn.posWorld, spawn.angle, compiledBody);
+}
+
+Box2dCompiledBody Box2dBodyTuner::CompileBodyOptions(const Box2dBodyOptions& options)
+{
+    Box2dCompiledBody compiledBody;
+    compiledBody.options = options;
+
+    auto& bodyDef = compiledBody.bodyDef;
+    switch (options.dynamic)
+    {
+    case Box2dBodyOptions::MovementPolicy::Box2dPhysicsNoGravity:
+        bodyDef.type = b2_dynamicBody;
+        bodyDef.gravityScale = 0.0f;
+        break;
+    case Box2dBodyOptions::MovementPolicy::Manual:
+        bodyDef.type = b2_staticBody;
+        break;
+    case Box2dBodyOptions::MovementPolicy::Box2dPhysics:
+        bodyDef.type = b2_dynamicBody;
+        bodyDef.gravityScale = 1.0f;
+        break;
+    }
+
+    if (options.anglePolicy == Box2dBodyOptions::AnglePolicy::Fixed)
+        bodyDef.fixedRotation = true;
+    else if (options.anglePolicy != Box2dBodyOptions::AnglePolicy::Dynamic && options.anglePolicy != Box2dBodyOptions::AnglePolicy::VelocityDirection)
+        throw std::runtime_error("[CompileBodyOptions] Unknown angle policy");
+
+    bodyDef.bullet = options.bulletPolicy == Box2dBodyOptions::BulletPolicy::Bullet;
+
+    compiledBody.fixtures = CompileShapeFixtures(options.shape, CalcFixtureDefFromOptions(options.fixture), options.hitbox.sizeWorld);
+    auto sensorFixtures = CompileSensorFixtures(options.sensor, options.hitbox.sizeWorld);
+    compiledBody.fixtures.insert(compiledBody.fixtures.end(), sensorFixtures.begin(), sensorFixtures.end());
+
+    // Collision policy is applied to all fixtures including the sensors.
+    for (auto& fixture : compiledBody.fixtures)
+    {
+        fixture.def.filter.categoryBits = static_cast<uint16>(options.collisionPolicy.ownCategoryOfCollision);
+        fixture.def.filter.maskBits = static_cast<uint16>(options.collisionPolicy.collideWith);
+    }
+
+    return compiledBody;
 }
 
 PhysicsComponent& Box2dBodyTuner::GetPhysicsComponent(entt::entity entity)
@@ -31,12 +69,23 @@ PhysicsComponent& Box2dBodyTuner::GetPhysicsComponent(entt::entity entity)
     return registry.get<PhysicsComponent>(entity);
 }
 
+void Box2dBodyTuner::UpdateTransformComponent(entt::entity entity)
+{
+    const b2Body* body = GetPhysicsComponent(entity).body;
+    auto& transform = registry.get<TransformComponent>(entity);
+    transform.positionPhysics = body->GetPosition();
+    transform.angle = body->GetAngle();
+    transform.positionWorld = coordinatesTransformer.PhysicsToWorld(transform.positionPhysics);
+    transform.previousPositionPhysics = transform.positionPhysics;
+    transform.previousAngle = transform.angle;
+}
+
 /////////////////////////////////////// Options setters. /////////////////////////////////////
 
 void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::Fixture& fixtureOptions)
 {
     auto& physicsComponent = GetPhysicsComponent(entity);
-    auto body = physicsComponent.bodyRAII->GetBody();
+    auto body = physicsComponent.body;
     physicsComponent.options.fixture = fixtureOptions;
 
     b2Fixture* fixture = body->GetFixtureList();
@@ -52,43 +101,29 @@ void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::Fi
 void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::Shape& option)
 {
     auto& physicsComponent = GetPhysicsComponent(entity);
-    auto body = physicsComponent.bodyRAII->GetBody();
+    auto body = physicsComponent.body;
     physicsComponent.options.shape = option;
 
     RemoveAllFixturesExceptSensorsFromTheBody(body);
 
     auto fixtureDef = CalcFixtureDefFromOptions(physicsComponent.options.fixture);
-
-    if (option == Box2dBodyOptions::Shape::Box)
-        AddBoxFixtureToBody(body, fixtureDef, physicsComponent.options.hitbox.sizeWorld);
-    else if (option == Box2dBodyOptions::Shape::Circle)
-        AddCircleFixtureToBody(body, fixtureDef, physicsComponent.options.hitbox.sizeWorld);
-    else if (option == Box2dBodyOptions::Shape::Capsule)
-        AddVerticalCapsuleFixtureToBody(body, fixtureDef, physicsComponent.options.hitbox.sizeWorld);
-    else
-        throw std::runtime_error("[ApplyOption] Unknown shape type");
+    CreateFixtures(body, CompileShapeFixtures(option, fixtureDef, physicsComponent.options.hitbox.sizeWorld));
 }
 
 void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::Sensor& option)
 {
     auto& physicsComponent = GetPhysicsComponent(entity);
-    auto body = physicsComponent.bodyRAII->GetBody();
+    auto body = physicsComponent.body;
     physicsComponent.options.sensor = option;
 
     RemoveAllSensorsFromTheBody(body);
-
-    if (option == Box2dBodyOptions::Sensor::ThinSensorBelow)
-        AddThinSensorBelowTheBody(body, physicsComponent.options.hitbox.sizeWorld);
-    else if (option == Box2dBodyOptions::Sensor::NoSensor)
-        return;
-    else
-        throw std::runtime_error("[ApplyOption] Unknown sensor type");
+    CreateFixtures(body, CompileSensorFixtures(option, physicsComponent.options.hitbox.sizeWorld));
 }
 
 void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::MovementPolicy& option)
 {
     auto& physicsComponent = GetPhysicsComponent(entity);
-    auto body = physicsComponent.bodyRAII->GetBody();
+    auto body = physicsComponent.body;
     physicsComponent.options.dynamic = option;
 
     switch (option)
@@ -105,13 +140,19 @@ void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::Mo
         body->SetType(b2_dynamicBody);
         break;
     }
+
+    // Previous transform may be stale. Static bodies are skipped by PhysicsSystem::SavePreviousTransforms, and the
+    // interpolation of the body which has just become dynamic must start from its current position.
+    UpdateTransformComponent(entity);
+    UpdateDynamicBodyTag(entity);
 }
 
 void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::AnglePolicy& option)
 {
     auto& physicsComponent = GetPhysicsComponent(entity);
-    auto body = physicsComponent.bodyRAII->GetBody();
+    auto body = physicsComponent.body;
     physicsComponent.options.anglePolicy = option;
+    EmplaceAnglePolicyTag(entity, option);
 
     if (option == Box2dBodyOptions::AnglePolicy::Dynamic)
         body->SetFixedRotation(false);
@@ -127,7 +168,7 @@ void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::An
 void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::CollisionPolicy& option)
 {
     auto& physicsComponent = GetPhysicsComponent(entity);
-    auto body = physicsComponent.bodyRAII->GetBody();
+    auto body = physicsComponent.body;
     physicsComponent.options.collisionPolicy = option;
 
     b2Fixture* fixture = body->GetFixtureList();
@@ -144,7 +185,7 @@ void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::Co
 void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::BulletPolicy& option)
 {
     auto& physicsComponent = GetPhysicsComponent(entity);
-    auto body = physicsComponent.bodyRAII->GetBody();
+    auto body = physicsComponent.body;
     physicsComponent.options.bulletPolicy = option;
 
     body->SetBullet(option == Box2dBodyOptions::BulletPolicy::Bullet);
@@ -160,94 +201,326 @@ void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::Hi
 
     objectHitbox = hitbox;
 
+    // Hitbox of the animated objects is changed often (e.g. Idle <-> Run). Don't recreate the fixtures in this case.
+    if (TryMorphFixtures(physicsComponent.body, physicsComponent.options.shape, hitbox.sizeWorld))
+        return;
+
     ApplyOption(entity, physicsComponent.options.shape);
 }
 
-/////////////////////////////////////// Create empty physics body. /////////////////////////////////////
+/////////////////////////////////////// Fixtures managed by the owner of the body. /////////////////////////////////////
 
-b2Body* Box2dBodyTuner::CreatePhysicsBodyWithNoShape(entt::entity entity, const glm::vec2& posWorld)
+b2Fixture* Box2dBodyTuner::AddBoxFixture(entt::entity entity, const glm::vec2& centerLocalWorld, const glm::vec2& sizeWorld)
 {
-    b2BodyDef bodyDef;
-    b2Vec2 posPhysics = coordinatesTransformer.WorldToPhysics(posWorld);
-    bodyDef.position.Set(posPhysics.x, posPhysics.y);
-    b2Body* body = gameState.physicsWorld->CreateBody(&bodyDef);
+    auto& physicsComponent = GetPhysicsComponent(entity);
+    auto body = physicsComponent.body;
+
+    auto fixtureDef = CalcFixtureDefFromOptions(physicsComponent.options.fixture);
+    fixtureDef.filter.categoryBits = static_cast<uint16>(physicsComponent.options.collisionPolicy.ownCategoryOfCollision);
+    fixtureDef.filter.maskBits = static_cast<uint16>(physicsComponent.options.collisionPolicy.collideWith);
+
+    b2PolygonShape shape;
+    b2Vec2 sizePhysics = coordinatesTransformer.WorldToPhysics(sizeWorld);
+    b2Vec2 centerPhysics = coordinatesTransformer.WorldToPhysics(centerLocalWorld);
+    shape.SetAsBox(sizePhysics.x / 2.0f, sizePhysics.y / 2.0f, centerPhysics, 0.0f);
+    fixtureDef.shape = &shape;
+    return body->CreateFixture(&fixtureDef);
+}
+
+b2Fixture* Box2dBodyTuner::AddChainFixture(entt::entity entity, const std::vector<glm::vec2>& verticesLocalWorld, bool isLoop)
+{
+    auto& physicsComponent = GetPhysicsComponent(entity);
+    auto body = physicsComponent.body;
+
+    auto fixtureDef = CalcFixtureDefFromOptions(physicsComponent.options.fixture);
+    fixtureDef.filter.categoryBits = static_cast<uint16>(physicsComponent.options.collisionPolicy.ownCategoryOfCollision);
+    fixtureDef.filter.maskBits = static_cast<uint16>(physicsComponent.options.collisionPolicy.collideWith);
+
+    std::vector<b2Vec2> verticesPhysics;
+    verticesPhysics.reserve(verticesLocalWorld.size());
+    for (const auto& vertexWorld : verticesLocalWorld)
+        verticesPhysics.push_back(coordinatesTransformer.WorldToPhysics(vertexWorld));
+
+    b2ChainShape shape;
+    if (isLoop)
+    {
+        shape.CreateLoop(verticesPhysics.data(), static_cast<int32>(verticesPhysics.size()));
+    }
+    else
+    {
+        // Ghost vertices continue the first and the last edges. Used by Box2D to smooth collisions on the chain ends.
+        b2Vec2 prevVertex = 2.0f * verticesPhysics.front() - verticesPhysics[1];
+        b2Vec2 nextVertex = 2.0f * verticesPhysics.back() - verticesPhysics[verticesPhysics.size() - 2];
+        shape.CreateChain(verticesPhysics.data(), static_cast<int32>(verticesPhysics.size()), prevVertex, nextVertex);
+    }
+
+    fixtureDef.shape = &shape;
+    return body->CreateFixture(&fixtureDef);
+}
+
+void Box2dBodyTuner::DestroyFixture(entt::entity entity, b2Fixture* fixture)
+{
+    auto& physicsComponent = GetPhysicsComponent(entity);
+    physicsComponent.body->DestroyFixture(fixture);
+}
+
+/////////////////////////////////////// Create physics body. /////////////////////////////////////
+
+PhysicsComponent& Box2dBodyTuner::CreatePhysicsComponent(entt::entity entity, const glm::vec2& posWorld, float angle, const Box2dCompiledBody& compiledBody)
+{
+    auto poolKey = Box2dBodyPool::MakeKey(compiledBody.options);
+    b2Body* body = poolKey && gameState.bodyPool ? gameState.bodyPool->Acquire(*poolKey) : nullptr;
+    if (body)
+        ResetPooledBody(body, entity, posWorld, angle, compiledBody);
+    else
+        body = CreatePhysicsBody(entity, posWorld, angle, compiledBody);
 
+    PhysicsComponent& physicsComponent = registry.emplace<PhysicsComponent>(entity, body, compiledBody.options);
+    EmplaceAnglePolicyTag(entity, compiledBody.options.anglePolicy);
+    registry.emplace_or_replace<TransformComponent>(entity);
+    UpdateTransformComponent(entity);
+    UpdateDynamicBodyTag(entity);
+    return physicsComponent;
+}
+
+b2Body* Box2dBodyTuner::CreatePhysicsBody(entt::entity entity, const glm::vec2& posWorld, float angle, const Box2dCompiledBody& compiledBody)
+{
+    b2BodyDef bodyDef = compiledBody.bodyDef;
+    bodyDef.position = coordinatesTransformer.WorldToPhysics(posWorld);
+    bodyDef.angle = angle;
     // Set the entity to the Box2D body user data. It will be used to get the entity from the Box2D body.
-    body->GetUserData().pointer = static_cast<uintptr_t>(entity);
+    bodyDef.userData.pointer = static_cast<uintptr_t>(entity);
+
+    b2Body* body = gameState.physicsWorld->CreateBody(&bodyDef);
+    CreateFixtures(body, compiledBody.fixtures);
     return body;
 }
 
-/////////////////////////////////////// Add simple fixtures to the body. /////////////////////////////////////
+void Box2dBodyTuner::EmplaceAnglePolicyTag(entt::entity entity, Box2dBodyOptions::AnglePolicy anglePolicy)
+{
+    registry.remove<FixedAngleComponent, DynamicAngleComponent, VelocityDirectionAngleComponent>(entity);
+
+    switch (anglePolicy)
+    {
+    case Box2dBodyOptions::AnglePolicy::Fixed:
+        registry.emplace<FixedAngleComponent>(entity);
+        break;
+    case Box2dBodyOptions::AnglePolicy::Dynamic:
+        registry.emplace<DynamicAngleComponent>(entity);
+        break;
+    case Box2dBodyOptions::AnglePolicy::VelocityDirection:
+        registry.emplace<VelocityDirectionAngleComponent>(entity);
+        break;
+    }
+}
+
+void Box2dBodyTuner::UpdateDynamicBodyTag(entt::entity entity)
+{
+    bool isDynamic = GetPhysicsComponent(entity).body->GetType() != b2_staticBody;
+    if (isDynamic)
+    {
+        registry.emplace_or_replace<DynamicBodyComponent>(entity);
+    }
+    else
+    {
+        registry.remove<DynamicBodyComponent>(entity);
+    }
+}
+
+/////////////////////////////////////// Pooled bodies. /////////////////////////////////////
 
-void Box2dBodyTuner::AddBoxFixtureToBody(b2Body* body, b2FixtureDef& fixtureDef, const glm::vec2& sizeWorld)
+void Box2dBodyTuner::ResetPooledBody(b2Body* body, entt::entity entity, const glm::vec2& posWorld, float angle, const Box2dCompiledBody& compiledBody)
 {
-    b2PolygonShape shape;
-    b2Vec2 sizePhysics = coordinatesTransformer.WorldToPhysics(sizeWorld);
-    shape.SetAsBox(sizePhysics.x / 2.0, sizePhysics.y / 2.0);
-    fixtureDef.shape = &shape;
-    body->CreateFixture(&fixtureDef);
+    const auto& bodyDef = compiledBody.bodyDef;
+    body->SetTransform(coordinatesTransformer.WorldToPhysics(posWorld), angle);
+    body->SetLinearVelocity({0.0f, 0.0f});
+    body->SetAngularVelocity(0.0f);
+    body->SetType(bodyDef.type);
+    body->SetGravityScale(bodyDef.gravityScale);
+    body->SetFixedRotation(bodyDef.fixedRotation);
+    body->SetBullet(bodyDef.bullet);
+    body->GetUserData().pointer = static_cast<uintptr_t>(entity);
+
+    // Shape and sensor are the same as in the pool key. Sensors keep the default fixture def. See CompileSensorFixtures.
+    const auto& fixtureOptions = compiledBody.options.fixture;
+    const auto& collisionPolicy = compiledBody.options.collisionPolicy;
+    for (b2Fixture* fixture = body->GetFixtureList(); fixture != nullptr; fixture = fixture->GetNext())
+    {
+        b2Filter filter = fixture->GetFilterData();
+        filter.categoryBits = static_cast<uint16>(collisionPolicy.ownCategoryOfCollision);
+        filter.maskBits = static_cast<uint16>(collisionPolicy.collideWith);
+        fixture->SetFilterData(filter);
+
+        if (fixture->IsSensor())
+            continue;
+
+        fixture->SetDensity(fixtureOptions.density);
+        fixture->SetFriction(fixtureOptions.friction);
+        fixture->SetRestitution(fixtureOptions.restitution);
+    }
+
+    // Type of the body may be the same as in the pool. Then Box2D doesn't recalculate the mass for the new density.
+    body->ResetMassData();
+    body->SetEnabled(true);
+    body->SetAwake(true);
 }
 
-void Box2dBodyTuner::AddCircleFixtureToBody(b2Body* body, b2FixtureDef& fixtureDef, const glm::vec2& sizeWorld)
+/////////////////////////////////////// Compile fixtures. /////////////////////////////////////
+
+std::vector<Box2dCompiledBody::Fixture> Box2dBodyTuner::CompileShapeFixtures(
+    Box2dBodyOptions::Shape shape, const b2FixtureDef& fixtureDef, const glm::vec2& sizeWorld)
 {
-    b2CircleShape shape;
+    std::vector<Box2dCompiledBody::Fixture> fixtures;
     b2Vec2 sizePhysics = coordinatesTransformer.WorldToPhysics(sizeWorld);
-    shape.m_radius = sizePhysics.x / 2.0;
-    fixtureDef.shape = &shape;
-    body->CreateFixture(&fixtureDef);
+
+    if (shape == Box2dBodyOptions::Shape::Box)
+    {
+        b2PolygonShape box;
+        box.SetAsBox(sizePhysics.x / 2.0, sizePhysics.y / 2.0);
+        fixtures.push_back({fixtureDef, box});
+    }
+    else if (shape == Box2dBodyOptions::Shape::Circle)
+    {
+        b2CircleShape circle;
+        circle.m_radius = sizePhysics.x / 2.0;
+        fixtures.push_back({fixtureDef, circle});
+    }
+    else if (shape == Box2dBodyOptions::Shape::Capsule)
+    {
+        // Vertical capsule.
+        float radius = sizePhysics.x / 2.0f; // Use width for radius to ensure the capsule fits within the given rectangle.
+        float boxHeight = sizePhysics.y - 2 * radius; // Calculate the height of the central rectangular part.
+
+        // Check if a central rectangular part is necessary.
+        if (boxHeight > 0)
+        {
+            b2PolygonShape boxShape;
+            boxShape.SetAsBox(radius, boxHeight / 2.0f, b2Vec2(0, 0), 0);
+            fixtures.push_back({fixtureDef, boxShape});
+        }
+
+        // Add the top circular end of the capsule.
+        b2CircleShape topCircle;
+        topCircle.m_p.Set(0, -boxHeight / 2.0f);
+        topCircle.m_radius = radius;
+        fixtures.push_back({fixtureDef, topCircle});
+
+        // Add the bottom circular end of the capsule.
+        b2CircleShape bottomCircle;
+        bottomCircle.m_p.Set(0, boxHeight / 2.0f);
+        bottomCircle.m_radius = radius;
+        fixtures.push_back({fixtureDef, bottomCircle});
+    }
+    else if (shape != Box2dBodyOptions::Shape::None)
+    {
+        throw std::runtime_error("[CompileShapeFixtures] Unknown shape type");
+    }
+
+    return fixtures;
 }
 
-void Box2dBodyTuner::AddVerticalCapsuleFixtureToBody(b2Body* body, b2FixtureDef& fixtureDef, const glm::vec2& sizeWorld)
+std::vector<Box2dCompiledBody::Fixture> Box2dBodyTuner::CompileSensorFixtures(Box2dBodyOptions::Sensor sensor, const glm::vec2& sizeWorld)
 {
-    // Convert world coordinates size to physical size for Box2D.
-    b2Vec2 sizePhysics = coordinatesTransformer.WorldToPhysics(sizeWorld);
-    float radius = sizePhysics.x / 2.0f; // Use width for radius to ensure the capsule fits within the given rectangle.
-    float boxHeight = sizePhysics.y - 2 * radius; // Calculate the height of the central rectangular part.
+    std::vector<Box2dCompiledBody::Fixture> fixtures;
 
-    // Check if a central rectangular part is necessary.
-    if (boxHeight > 0)
+    if (sensor == Box2dBodyOptions::Sensor::ThinSensorBelow)
     {
-        b2PolygonShape boxShape;
-        boxShape.SetAsBox(radius, boxHeight / 2.0f, b2Vec2(0, 0), 0);
-        fixtureDef.shape = &boxShape;
-        body->CreateFixture(&fixtureDef);
+        // Parameters for the sensor.
+        float widthFillKoef = 0.75f; // Use to prevent collision with left and right walls.
+        float hh = 0.015f; // Half height of the sensor.
+
+        b2PolygonShape sensorShape;
+        b2Vec2 sizePhysics = coordinatesTransformer.WorldToPhysics(sizeWorld);
+        float hw = sizePhysics.x / 2.0f * widthFillKoef;
+        // Move center of polygon to the bottom of the body. Slighly above the ground.
+        b2Vec2 center(0, sizePhysics.y / 2.0f + hh);
+        float angle = 0;
+        sensorShape.SetAsBox(hw, hh, center, angle);
+
+        b2FixtureDef sensorDef;
+        sensorDef.isSensor = true;
+        fixtures.push_back({sensorDef, sensorShape});
+    }
+    else if (sensor != Box2dBodyOptions::Sensor::NoSensor)
+    {
+        throw std::runtime_error("[CompileSensorFixtures] Unknown sensor type");
     }
 
-    // Add the top circular end of the capsule.
-    b2CircleShape topCircle;
-    topCircle.m_p.Set(0, -boxHeight / 2.0f);
-    topCircle.m_radius = radius;
-    fixtureDef.shape = &topCircle;
-    body->CreateFixture(&fixtureDef);
-
-    // Add the bottom circular end of the capsule.
-    b2CircleShape bottomCircle;
-    bottomCircle.m_p.Set(0, boxHeight / 2.0f);
-    bottomCircle.m_radius = radius;
-    fixtureDef.shape = &bottomCircle;
-    body->CreateFixture(&fixtureDef);
+    return fixtures;
+}
+
+void Box2dBodyTuner::CreateFixtures(b2Body* body, const std::vector<Box2dCompiledBody::Fixture>& fixtures)
+{
+    for (const auto& fixture : fixtures)
+    {
+        b2FixtureDef fixtureDef = fixture.def;
+        fixtureDef.shape = std::visit([](const auto& shape) -> const b2Shape* { return &shape; }, fixture.shape);
+        body->CreateFixture(&fixtureDef);
+    }
 }
 
-void Box2dBodyTuner::AddThinSensorBelowTheBody(b2Body* body, const glm::vec2& sizeWorld)
+/////////////////////////////////////// Resize fixtures of the body. /////////////////////////////////////
+
+bool Box2dBodyTuner::TryMorphFixtures(b2Body* body, Box2dBodyOptions::Shape shape, const glm::vec2& sizeWorld)
 {
-    // Parameters for the sensor.
-    float widthFillKoef = 0.75f; // Use to prevent collision with left and right walls.
-    float hh = 0.015f; // Half height of the sensor.
+    std::vector<b2PolygonShape*> polygons;
+    std::vector<b2CircleShape*> circles;
+    for (b2Fixture* fixture = body->GetFixtureList(); fixture != nullptr; fixture = fixture->GetNext())
+    {
+        if (fixture->IsSensor())
+            continue;
+
+        if (fixture->GetType() == b2Shape::e_polygon)
+            polygons.push_back(static_cast<b2PolygonShape*>(fixture->GetShape()));
+        else if (fixture->GetType() == b2Shape::e_circle)
+            circles.push_back(static_cast<b2CircleShape*>(fixture->GetShape()));
+        else
+            return false;
+    }
 
-    b2PolygonShape sensorShape;
     b2Vec2 sizePhysics = coordinatesTransformer.WorldToPhysics(sizeWorld);
-    float hw = sizePhysics.x / 2.0f * widthFillKoef;
-    // Move center of polygon to the bottom of the body. Slighly above the ground.
-    b2Vec2 center(0, sizePhysics.y / 2.0f + hh);
-    float angle = 0;
-    sensorShape.SetAsBox(hw, hh, center, angle);
-
-    b2FixtureDef sensorDef;
-    sensorDef.shape = &sensorShape;
-    sensorDef.isSensor = true;
-
-    // Add a sensor to the body below the body.
-    body->CreateFixture(&sensorDef);
+    if (shape == Box2dBodyOptions::Shape::Box)
+    {
+        if (polygons.size() != 1 || !circles.empty())
+            return false;
+
+        polygons[0]->SetAsBox(sizePhysics.x / 2.0, sizePhysics.y / 2.0);
+    }
+    else if (shape == Box2dBodyOptions::Shape::Circle)
+    {
+        if (!polygons.empty() || circles.size() != 1)
+            return false;
+
+        circles[0]->m_radius = sizePhysics.x / 2.0;
+    }
+    else if (shape == Box2dBodyOptions::Shape::Capsule)
+    {
+        // Same layout as in CompileShapeFixtures.
+        float radius = sizePhysics.x / 2.0f;
+        float boxHeight = sizePhysics.y - 2 * radius;
+        if (polygons.size() != (boxHeight > 0 ? 1u : 0u) || circles.size() != 2)
+            return false;
+
+        if (boxHeight > 0)
+            polygons[0]->SetAsBox(radius, boxHeight / 2.0f, b2Vec2(0, 0), 0);
+
+        // Top circle has the negative Y. Keep the roles of the fixtures.
+        if (circles[0]->m_p.y > circles[1]->m_p.y)
+            std::swap(circles[0], circles[1]);
+        circles[0]->m_p.Set(0, -boxHeight / 2.0f);
+        circles[1]->m_p.Set(0, boxHeight / 2.0f);
+        for (auto circle : circles)
+            circle->m_radius = radius;
+    }
+    else
+    {
+        return false;
+    }
+
+    body->ResetMassData();
+    // Update AABBs of the broadphase proxies. Proxies are moved only if the new AABB leaves the fat one.
+    body->SetTransform(body->GetPosition(), body->GetAngle());
+    return true;
 }
 
 /////////////////////////////////////// Remove fixtures from the body. /////////////////////////////////////
@@ -4,9 +4,11 @@
 #include <ecs/components/physics_components.h>
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
-#include <utils/box2d/box2d_RAII.h>
+#include <span>
 #include <utils/box2d/box2d_body_options.h>
+#include <utils/box2d/box2d_compiled_body.h>
 #include <utils/coordinates_transformer.h>
+#include <vector>
 
 class Box2dBodyTuner
 {
@@ -16,9 +18,23 @@ class Box2dBodyTuner
 public: //////////////////////////////////////////// Constructor. ///////////////////////////////////////////
     Box2dBodyTuner(entt::registry& registry);
 public: ////////////////////////////////////// Create physics component. ////////////////////////////////////
+    struct BodySpawn
+    {
+        entt::entity entity;
+        glm::vec2 posWorld;
+        float angle = 0.0f;
+    };
+
     PhysicsComponent& CreatePhysicsComponent(entt::entity entity, const glm::vec2& posWorld, float angle, const Box2dBodyOptions& options);
+    // Compile the options once and create the bodies of all entities. Used for bulk spawns (map loading, explosions).
+    void CreatePhysicsComponents(std::span<const BodySpawn> spawns, const Box2dBodyOptions& options);
+    // Convert the options to the body def and the fixture defs. Sizes are converted to the physics coordinates.
+    Box2dCompiledBody CompileBodyOptions(const Box2dBodyOptions& options);
 public: //////////////// Get physics component or throw exception. May be used to get options. //////////////
     PhysicsComponent& GetPhysicsComponent(entt::entity entity);
+public: //////////////////////////////////////////// Transform cache. ///////////////////////////////////////////
+    // Copy the transform of the body to TransformComponent. Previous transform is reset, so the moved body is not interpolated.
+    void UpdateTransformComponent(entt::entity entity);
 public: /////////////////////////////////////////// Options setters. /////////////////////////////////////////
     void ApplyOption(entt::entity entity, const Box2dBodyOptions::Fixture& fixture);
     void ApplyOption(entt::entity entity, const Box2dBodyOptions::Shape& option);
@@ -28,13 +44,32 @@ public: /////////////////////////////////////////// Options setters. ///////////
     void ApplyOption(entt::entity entity, const Box2dBodyOptions::CollisionPolicy& option);
     void ApplyOption(entt::entity entity, const Box2dBodyOptions::BulletPolicy& option);
     void ApplyOption(entt::entity entity, const Box2dBodyOptions::Hitbox& hitbox);
-private: ///////////////////////////////////// Create empty physics body. ///////////////////////////////////
-    b2Body* CreatePhysicsBodyWithNoShape(entt::entity entity, const glm::vec2& posWorld);
-private: ////////////////////////////////// Add simple fixtures to the body. ////////////////////////////////
-    void AddBoxFixtureToBody(b2Body* body, b2FixtureDef& fixtureDef, const glm::vec2& sizeWorld);
-    void AddCircleFixtureToBody(b2Body* body, b2FixtureDef& fixtureDef, const glm::vec2& sizeWorld);
-    void AddVerticalCapsuleFixtureToBody(b2Body* body, b2FixtureDef& fixtureDef, const glm::vec2& sizeWorld);
-    void AddThinSensorBelowTheBody(b2Body* body, const glm::vec2& sizeWorld);
+public: ///////////////////////////// Fixtures managed by the owner of the body (Shape::None). ///////////////////////////
+    // Add box fixture with the current fixture and collision options. `centerLocalWorld` is relative to the body position.
+    b2Fixture* AddBoxFixture(entt::entity entity, const glm::vec2& centerLocalWorld, const glm::vec2& sizeWorld);
+    // Add chain fixture with the current fixture and collision options. Vertices are relative to the body position.
+    // Chain edges are one-sided: collision normal points to the right side of the chain direction in Box2D terms.
+    b2Fixture* AddChainFixture(entt::entity entity, const std::vector<glm::vec2>& verticesLocalWorld, bool isLoop);
+    void DestroyFixture(entt::entity entity, b2Fixture* fixture);
+private: ///////////////////////////////////// Create physics body. ///////////////////////////////////////
+    PhysicsComponent& CreatePhysicsComponent(entt::entity entity, const glm::vec2& posWorld, float angle, const Box2dCompiledBody& compiledBody);
+    b2Body* CreatePhysicsBody(entt::entity entity, const glm::vec2& posWorld, float angle, const Box2dCompiledBody& compiledBody);
+    // Replace the angle policy tag of the entity. PhysicsSystem selects the bodies to rotate by these tags.
+    void EmplaceAnglePolicyTag(entt::entity entity, Box2dBodyOptions::AnglePolicy anglePolicy);
+    // Attach DynamicBodyComponent if the body is not static. Remove it otherwise.
+    void UpdateDynamicBodyTag(entt::entity entity);
+private: //////////////////////////////////////////// Pooled bodies. ///////////////////////////////////////////
+    // Fixtures of the pooled body already match the shape. Reset the state left from the previous owner of the body.
+    void ResetPooledBody(b2Body* body, entt::entity entity, const glm::vec2& posWorld, float angle, const Box2dCompiledBody& compiledBody);
+private: /////////////////////////////////////////// Compile fixtures. //////////////////////////////////////////
+    // Fixtures of the shape. `fixtureDef` is used for all of them.
+    std::vector<Box2dCompiledBody::Fixture> CompileShapeFixtures(Box2dBodyOptions::Shape shape, const b2FixtureDef& fixtureDef, const glm::vec2& sizeWorld);
+    std::vector<Box2dCompiledBody::Fixture> CompileSensorFixtures(Box2dBodyOptions::Sensor sensor, const glm::vec2& sizeWorld);
+    static void CreateFixtures(b2Body* body, const std::vector<Box2dCompiledBody::Fixture>& fixtures);
+private: ////////////////////////////////// Resize fixtures of the body. ////////////////////////////////////
+    // Resize the existing fixtures of the shape in place. Fixtures and their broadphase proxies are kept.
+    // Return false if the fixtures don't match the layout of the shape with the new size, e.g. the capsule becomes a circle.
+    bool TryMorphFixtures(b2Body* body, Box2dBodyOptions::Shape shape, const glm::vec2& sizeWorld);
 private: /////////////////////////////////// Remove fixtures from the body. /////////////////////////////////
     void RemoveAllFixturesExceptSensorsFromTheBody(b2Body* body);
     void RemoveAllSensorsFromTheBody(b2Body* body);
@@ -0,0 +1,20 @@
+#pragma once
+#include <box2d/box2d.h>
+#include <utils/box2d/box2d_body_options.h>
+#include <variant>
+#include <vector>
+
+// Box2dBodyOptions compiled to the Box2D definitions. Many bodies with the same options are created from it
+// without applying the options one by one. See Box2dBodyTuner::CompileBodyOptions.
+struct Box2dCompiledBody
+{
+    struct Fixture
+    {
+        b2FixtureDef def; // `def.shape` is set to `shape` when the fixture is created.
+        std::variant<b2PolygonShape, b2CircleShape> shape;
+    };
+
+    Box2dBodyOptions options;
+    b2BodyDef bodyDef; // Position, angle and user data are set for each body.
+    std::vector<Fixture> fixtures; // In the order of creation. Sensors are the last.
+};
@@ -0,0 +1,20 @@
+#include "box2d_interpolation.h"
+#include <cmath>
+#include <numbers>
+
+namespace utils
+{
+
+b2Vec2 GetInterpolatedPosition(const TransformComponent& transform, float alpha)
+{
+    return transform.previousPositionPhysics + alpha * (transform.positionPhysics - transform.previousPositionPhysics);
+}
+
+float GetInterpolatedAngle(const TransformComponent& transform, float alpha)
+{
+    // Angle may be set directly (e.g. AnglePolicy::VelocityDirection). Interpolate over the shortest arc.
+    float delta = std::remainder(transform.angle - transform.previousAngle, 2.0f * std::numbers::pi_v<float>);
+    return transform.angle - (1.0f - alpha) * delta;
+}
+
+} // namespace utils
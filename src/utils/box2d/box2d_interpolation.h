@@ -0,0 +1,13 @@
+#pragma once
+#include <box2d/box2d.h>
+#include <ecs/components/physics_components.h>
+
+namespace utils
+{
+
+// Transform of the body between the last two fixed physics steps. `alpha` is GameOptions::physicsOptions.interpolationAlpha.
+// Used by the rendering and the camera to move smoothly when the render rate differs from the physics rate.
+b2Vec2 GetInterpolatedPosition(const TransformComponent& transform, float alpha);
+float GetInterpolatedAngle(const TransformComponent& transform, float alpha);
+
+} // namespace utils
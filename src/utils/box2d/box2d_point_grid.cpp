@@ -0,0 +1,176 @@
+#include "box2d_point_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utils/logger.h>
+
+Box2dPointGrid::Box2dPointGrid(float cellSizePhysics) : cellSize(cellSizePhysics)
+{
+    if (cellSize <= 0.0f)
+        throw std::runtime_error(MY_FMT("[Box2dPointGrid] Cell size must be positive, got {}", cellSize));
+}
+
+void Box2dPointGrid::Insert(entt::entity entity, const b2Vec2& posPhysics)
+{
+    int cellX = ToCell(posPhysics.x);
+    int cellY = ToCell(posPhysics.y);
+    cells[MakeCellKey(cellX, cellY)].push_back({entity, posPhysics});
+
+    if (itemsCount == 0)
+    {
+        minCellX = maxCellX = cellX;
+        minCellY = maxCellY = cellY;
+    }
+    else
+    {
+        minCellX = std::min(minCellX, cellX);
+        minCellY = std::min(minCellY, cellY);
+        maxCellX = std::max(maxCellX, cellX);
+        maxCellY = std::max(maxCellY, cellY);
+    }
+    itemsCount++;
+}
+
+void Box2dPointGrid::Remove(entt::entity entity, const b2Vec2& posPhysics)
+{
+    auto it = cells.find(MakeCellKey(ToCell(posPhysics.x), ToCell(posPhysics.y)));
+    if (it == cells.end())
+        return;
+
+    auto& items = it->second;
+    auto itemIt = std::find_if(items.begin(), items.end(), [entity](const Item& item) { return item.entity == entity; });
+    if (itemIt == items.end())
+        return;
+
+    items.erase(itemIt);
+    if (items.empty())
+        cells.erase(it);
+    itemsCount--;
+}
+
+std::vector<entt::entity> Box2dPointGrid::FindInRadius(const b2Vec2& centerPhysics, float radiusPhysics) const
+{
+    std::vector<entt::entity> result;
+    auto collectFromCell = [&](const std::vector<Item>& items)
+    {
+        for (const auto& item : items)
+            if (b2Distance(centerPhysics, item.posPhysics) < radiusPhysics)
+                result.push_back(item.entity);
+    };
+
+    if (itemsCount == 0)
+        return result;
+
+    int beginX = std::max(ToCell(centerPhysics.x - radiusPhysics), minCellX);
+    int beginY = std::max(ToCell(centerPhysics.y - radiusPhysics), minCellY);
+    int endX = std::min(ToCell(centerPhysics.x + radiusPhysics), maxCellX); // Inclusive.
+    int endY = std::min(ToCell(centerPhysics.y + radiusPhysics), maxCellY); // Inclusive.
+    if (beginX > endX || beginY > endY)
+        return result;
+
+    // Big radius covers more cells than occupied ones. Check all items in this case.
+    size_t cellsInRange = static_cast<size_t>(endX - beginX + 1) * static_cast<size_t>(endY - beginY + 1);
+    if (cellsInRange > cells.size())
+    {
+        for (const auto& [key, items] : cells)
+            collectFromCell(items);
+        return result;
+    }
+
+    for (int cellY = beginY; cellY <= endY; ++cellY)
+    {
+        for (int cellX = beginX; cellX <= endX; ++cellX)
+        {
+            auto it = cells.find(MakeCellKey(cellX, cellY));
+            if (it != cells.end())
+                collectFromCell(it->second);
+        }
+    }
+    return result;
+}
+
+std::optional<entt::entity> Box2dPointGrid::FindClosest(const b2Vec2& anchorPhysics) const
+{
+    float minDistance = std::numeric_limits<float>::max();
+    std::optional<entt::entity> closestEntity;
+    if (itemsCount == 0)
+        return closestEntity;
+
+    int anchorX = ToCell(anchorPhysics.x);
+    int anchorY = ToCell(anchorPhysics.y);
+    int maxRing = std::max({anchorX - minCellX, maxCellX - anchorX, anchorY - minCellY, maxCellY - anchorY});
+
+    // Anchor is far from the occupied cells. Rings would visit more empty cells than there are items.
+    size_t ringCellsUpperBound = static_cast<size_t>(2 * maxRing + 1) * static_cast<size_t>(2 * maxRing + 1);
+    if (ringCellsUpperBound > itemsCount)
+    {
+        for (const auto& [key, items] : cells)
+        {
+            for (const auto& item : items)
+            {
+                float distance = b2Distance(item.posPhysics, anchorPhysics);
+                if (distance < minDistance)
+                {
+                    minDistance = distance;
+                    closestEntity = item.entity;
+                }
+            }
+        }
+        return closestEntity;
+    }
+
+    for (int ring = 0; ring <= maxRing; ++ring)
+    {
+        if (ring == 0)
+        {
+            VisitCellForClosest(anchorX, anchorY, anchorPhysics, minDistance, closestEntity);
+        }
+        else
+        {
+            for (int cellX = anchorX - ring; cellX <= anchorX + ring; ++cellX)
+            {
+                VisitCellForClosest(cellX, anchorY - ring, anchorPhysics, minDistance, closestEntity);
+                VisitCellForClosest(cellX, anchorY + ring, anchorPhysics, minDistance, closestEntity);
+            }
+            for (int cellY = anchorY - ring + 1; cellY <= anchorY + ring - 1; ++cellY)
+            {
+                VisitCellForClosest(anchorX - ring, cellY, anchorPhysics, minDistance, closestEntity);
+                VisitCellForClosest(anchorX + ring, cellY, anchorPhysics, minDistance, closestEntity);
+            }
+        }
+
+        // Items of the next rings are at least `ring * cellSize` away from any point of the anchor cell.
+        if (closestEntity && minDistance <= ring * cellSize)
+            break;
+    }
+    return closestEntity;
+}
+
+int Box2dPointGrid::ToCell(float coordPhysics) const
+{
+    return static_cast<int>(std::floor(coordPhysics / cellSize));
+}
+
+uint64_t Box2dPointGrid::MakeCellKey(int cellX, int cellY)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+void Box2dPointGrid::VisitCellForClosest(
+    int cellX, int cellY, const b2Vec2& anchorPhysics, float& minDistance, std::optional<entt::entity>& closestEntity) const
+{
+    auto it = cells.find(MakeCellKey(cellX, cellY));
+    if (it == cells.end())
+        return;
+
+    for (const auto& item : it->second)
+    {
+        float distance = b2Distance(item.posPhysics, anchorPhysics);
+        if (distance < minDistance)
+        {
+            minDistance = distance;
+            closestEntity = item.entity;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <box2d/box2d.h>
+#include <cstdint>
+#include <entt/entt.hpp>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// Uniform grid of the entity positions in the physics coordinates. Built once for a batch of queries from many points,
+// so the cost of each query depends only on the number of entities near the point.
+class Box2dPointGrid
+{
+    struct Item
+    {
+        entt::entity entity;
+        b2Vec2 posPhysics;
+    };
+
+    float cellSize;
+    std::unordered_map<uint64_t, std::vector<Item>> cells;
+    size_t itemsCount = 0;
+    // Bounds of the occupied cells. Valid only if `itemsCount` is not 0.
+    int minCellX = 0;
+    int minCellY = 0;
+    int maxCellX = 0;
+    int maxCellY = 0;
+public:
+    explicit Box2dPointGrid(float cellSizePhysics);
+    void Insert(entt::entity entity, const b2Vec2& posPhysics);
+    // Remove the entity inserted with the same position. Bounds of the occupied cells are not shrunk.
+    void Remove(entt::entity entity, const b2Vec2& posPhysics);
+    size_t GetItemsCount() const { return itemsCount; }
+public: ////////////////////////////////////////////// Queries. ////////////////////////////////////////////////
+    // Return entities with the position inside the circle. Order is not defined.
+    std::vector<entt::entity> FindInRadius(const b2Vec2& centerPhysics, float radiusPhysics) const;
+    // Search the cells in the rings around the anchor until the closest entity is proven.
+    std::optional<entt::entity> FindClosest(const b2Vec2& anchorPhysics) const;
+private:
+    int ToCell(float coordPhysics) const;
+    static uint64_t MakeCellKey(int cellX, int cellY);
+    // Update the closest entity with the items of the cell.
+    void VisitCellForClosest(int cellX, int cellY, const b2Vec2& anchorPhysics, float& minDistance, std::optional<entt::entity>& closestEntity) const;
+};
@@ -0,0 +1,102 @@
+#include "box2d_spatial_query.h"
+#include <algorithm>
+#include <ecs/components/physics_components.h>
+#include <limits>
+#include <my_cpp_utils/config.h>
+#include <utils/game_options.h>
+
+namespace
+{
+
+// Collect entities of the bodies with fixtures overlapping the box. Body with several fixtures is reported several times.
+class EntityQueryCallback : public b2QueryCallback
+{
+public:
+    std::vector<entt::entity> entities;
+
+    bool ReportFixture(b2Fixture* fixture) override
+    {
+        auto pointer = fixture->GetBody()->GetUserData().pointer;
+        if (pointer != 0)
+            entities.push_back(static_cast<entt::entity>(pointer));
+        return true; // Continue the query.
+    }
+};
+
+std::vector<entt::entity> CollectEntitiesInBox(entt::registry& registry, const b2Vec2& centerPhysics, float halfSizePhysics)
+{
+    auto& gameState = registry.get<GameOptions>(registry.view<GameOptions>().front());
+
+    b2AABB aabb;
+    aabb.lowerBound = centerPhysics - b2Vec2(halfSizePhysics, halfSizePhysics);
+    aabb.upperBound = centerPhysics + b2Vec2(halfSizePhysics, halfSizePhysics);
+
+    EntityQueryCallback callback;
+    gameState.physicsWorld->QueryAABB(&callback, aabb);
+    return std::move(callback.entities);
+}
+
+} // namespace
+
+namespace utils
+{
+
+std::vector<entt::entity> QueryEntitiesInBox(entt::registry& registry, const b2Vec2& centerPhysics, float halfSizePhysics)
+{
+    auto entities = CollectEntitiesInBox(registry, centerPhysics, halfSizePhysics);
+    std::sort(entities.begin(), entities.end());
+    entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+    return entities;
+}
+
+std::vector<entt::entity> QueryEntitiesInRadius(
+    entt::registry& registry, const b2Vec2& centerPhysics, float radiusPhysics, const std::function<bool(entt::entity)>& predicate)
+{
+    std::vector<entt::entity> entitiesInRadius;
+    for (auto entity : QueryEntitiesInBox(registry, centerPhysics, radiusPhysics))
+    {
+        auto transform = registry.try_get<TransformComponent>(entity);
+        if (!transform || b2Distance(centerPhysics, transform->positionPhysics) >= radiusPhysics)
+            continue;
+
+        if (predicate && !predicate(entity))
+            continue;
+
+        entitiesInRadius.push_back(entity);
+    }
+    return entitiesInRadius;
+}
+
+std::optional<entt::entity> QueryClosestEntity(entt::registry& registry, const b2Vec2& anchorPhysics, const std::function<bool(entt::entity)>& predicate)
+{
+    float halfSize = utils::GetConfig<float, "SpatialQuery.closestInitialHalfSize">();
+    auto& closestMaxGrowSteps = utils::GetConfig<size_t, "SpatialQuery.closestMaxGrowSteps">();
+    for (size_t step = 0; step <= closestMaxGrowSteps; ++step, halfSize *= 2.0f)
+    {
+        // Duplicates of the bodies with several fixtures don't change the closest entity.
+        float minDistance = std::numeric_limits<float>::max();
+        std::optional<entt::entity> closestEntity;
+        for (auto entity : CollectEntitiesInBox(registry, anchorPhysics, halfSize))
+        {
+            auto transform = registry.try_get<TransformComponent>(entity);
+            if (!transform || (predicate && !predicate(entity)))
+                continue;
+
+            float distance = b2Distance(transform->positionPhysics, anchorPhysics);
+            if (distance < minDistance)
+            {
+                minDistance = distance;
+                closestEntity = entity;
+            }
+        }
+
+        // Any closer entity has the position inside the circle of `minDistance`. If the circle fits into the box,
+        // the entity was already checked.
+        if (closestEntity && minDistance <= halfSize)
+            return closestEntity;
+    }
+
+    return std::nullopt;
+}
+
+} // namespace utils
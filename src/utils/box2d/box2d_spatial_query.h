@@ -0,0 +1,31 @@
+#pragma once
+#include <box2d/box2d.h>
+#include <entt/entt.hpp>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace utils
+{
+
+// Spatial queries over the Box2D broadphase of GameOptions::physicsWorld. Cost is proportional to the number of
+// bodies near the query instead of the number of entities in the registry.
+// Position of the entity is TransformComponent::positionPhysics. Only enabled bodies with at least one fixture are
+// found, so the pooled bodies are never returned.
+
+// Return entities with at least one fixture overlapping the box. Position of the entity may be outside of the box.
+// Each entity is returned once.
+std::vector<entt::entity> QueryEntitiesInBox(entt::registry& registry, const b2Vec2& centerPhysics, float halfSizePhysics);
+
+// Return entities with TransformComponent and the position inside the circle. Each entity is returned once.
+// `predicate` is optional. It is called once per candidate entity.
+std::vector<entt::entity> QueryEntitiesInRadius(
+    entt::registry& registry, const b2Vec2& centerPhysics, float radiusPhysics, const std::function<bool(entt::entity)>& predicate = nullptr);
+
+// Return the entity with TransformComponent closest to the anchor. The search box starts from
+// `SpatialQuery.closestInitialHalfSize` and doubles at most `SpatialQuery.closestMaxGrowSteps` times until a candidate
+// is proven to be the closest one. Return std::nullopt otherwise. Then the caller should scan the entities directly.
+std::optional<entt::entity> QueryClosestEntity(
+    entt::registry& registry, const b2Vec2& anchorPhysics, const std::function<bool(entt::entity)>& predicate = nullptr);
+
+} // namespace utils
@@ -14,11 +14,12 @@ void Box2dUtils::ApplyForceToPhysicalBodies(std::vector<entt::entity> physicalEn
 
     for (auto& entity : physicalEntities)
     {
-        auto originalObjPhysicsInfo = registry.get<PhysicsComponent>(entity).bodyRAII->GetBody();
-        const b2Vec2& posPhysics = originalObjPhysicsInfo->GetPosition();
+        auto originalObjPhysicsInfo = registry.get<PhysicsComponent>(entity).body;
+        const b2Vec2& posPhysics = registry.get<TransformComponent>(entity).positionPhysics;
 
         // Make target body as dynamic.
         originalObjPhysicsInfo->SetType(b2_dynamicBody);
+        registry.emplace_or_replace<DynamicBodyComponent>(entity);
 
         // Apply force to the target.
         // Force direction is from grenade to target. Inside. This greate interesting effect.
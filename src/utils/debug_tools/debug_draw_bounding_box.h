@@ -31,7 +31,7 @@ void DrawBoudingBoxesAdvanced(
 
         const auto& physicsInfo = view.template get<PhysicsComponent>(entity);
 
-        auto body = physicsInfo.bodyRAII->GetBody();
+        auto body = physicsInfo.body;
         for (auto fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext())
         {
             if (!(options & DrawBoudingBoxesOptions::DrawSensors))
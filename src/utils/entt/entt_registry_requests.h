@@ -3,15 +3,32 @@
 #include <ecs/components/physics_components.h>
 #include <entt/entity/fwd.hpp>
 #include <entt/entt.hpp>
+#include <functional>
+#include <limits>
+#include <my_cpp_utils/config.h>
 #include <optional>
+#include <utils/box2d/box2d_point_grid.h>
+#include <utils/box2d/box2d_spatial_query.h>
 
 namespace request
 {
 
+// Scan the view if it is small. Otherwise search near the anchor in the Box2D broadphase first and fall back to the scan
+// if the closest entity is far away.
 template <typename... ComponentTypes>
 std::optional<entt::entity> FindClosestEntityWithAllComponents(entt::registry& registry, const b2Vec2& anchorPosWorld, std::function<bool(entt::entity)> optTruePredicate = nullptr)
 {
-    auto targetEntities = registry.view<PhysicsComponent, ComponentTypes...>();
+    auto targetEntities = registry.view<TransformComponent, ComponentTypes...>();
+    if (targetEntities.size_hint() > utils::GetConfig<size_t, "SpatialQuery.closestScanMaxEntities">())
+    {
+        auto closestEntity = utils::QueryClosestEntity(
+            registry, anchorPosWorld,
+            [&registry, &optTruePredicate](entt::entity entity)
+            { return registry.all_of<ComponentTypes...>(entity) && (!optTruePredicate || optTruePredicate(entity)); });
+        if (closestEntity.has_value())
+            return closestEntity;
+    }
+
     float minDistance = std::numeric_limits<float>::max();
     std::optional<entt::entity> closestTargetEntity;
     for (auto targetEntity : targetEntities)
@@ -19,8 +36,7 @@ std::optional<entt::entity> FindClosestEntityWithAllComponents(entt::registry& r
         if (optTruePredicate && !optTruePredicate(targetEntity))
             continue;
 
-        auto& targetPhysicsComponent = targetEntities.template get<PhysicsComponent>(targetEntity);
-        auto targetPos = targetPhysicsComponent.bodyRAII->GetBody()->GetPosition();
+        const auto& targetPos = targetEntities.template get<TransformComponent>(targetEntity).positionPhysics;
         float distance = b2Distance(targetPos, anchorPosWorld);
         if (distance < minDistance)
         {
@@ -39,27 +55,25 @@ std::optional<b2Vec2> FindClosestEntityPosWithAllComponents(entt::registry& regi
     if (!entityOpt.has_value())
         return std::nullopt;
 
-    auto& physicsComponent = registry.get<PhysicsComponent>(entityOpt.value());
-    return physicsComponent.bodyRAII->GetBody()->GetPosition();
+    return registry.get<TransformComponent>(entityOpt.value()).positionPhysics;
 }
 
 template <typename... ComponentTypes>
 std::vector<entt::entity> FindEntitiesWithAllComponentsInRadius(entt::registry& registry, const b2Vec2& centerPosPhysics, float radiusPhysics)
 {
-    std::vector<entt::entity> entitiesInRadius;
-    auto view = registry.view<PhysicsComponent, ComponentTypes...>();
+    return utils::QueryEntitiesInRadius(
+        registry, centerPosPhysics, radiusPhysics, [&registry](entt::entity entity) { return registry.all_of<ComponentTypes...>(entity); });
+}
 
+// Grid of the positions of all entities with the components. Build it once and use it for the queries from many points.
+template <typename... ComponentTypes>
+Box2dPointGrid BuildPointGridWithAllComponents(entt::registry& registry)
+{
+    Box2dPointGrid grid(utils::GetConfig<float, "SpatialQuery.gridCellSize">());
+    auto view = registry.view<TransformComponent, ComponentTypes...>();
     for (auto entity : view)
-    {
-        const auto& physicsComponent = view.template get<PhysicsComponent>(entity);
-        const auto& entityPos = physicsComponent.bodyRAII->GetBody()->GetPosition();
-
-        if (b2Distance(centerPosPhysics, entityPos) < radiusPhysics)
-        {
-            entitiesInRadius.push_back(entity);
-        }
-    }
-    return entitiesInRadius;
+        grid.Insert(entity, view.template get<TransformComponent>(entity).positionPhysics);
+    return grid;
 }
 
 template <typename... ComponentTypes>
@@ -70,11 +84,10 @@ std::vector<entt::entity> FilterEntitiesWithAllComponentsInRadius(
     for (auto entity : entities)
     {
         // Check if the entity has all the required components.
-        if (!registry.all_of<PhysicsComponent, ComponentTypes...>(entity))
+        if (!registry.all_of<TransformComponent, ComponentTypes...>(entity))
             continue;
 
-        auto& physicsComponent = registry.get<PhysicsComponent>(entity);
-        auto entityPos = physicsComponent.bodyRAII->GetBody()->GetPosition();
+        const auto& entityPos = registry.get<TransformComponent>(entity).positionPhysics;
         if (b2Distance(centerPosPhysics, entityPos) < radiusPhysics)
             entitiesInRadius.push_back(entity);
     }
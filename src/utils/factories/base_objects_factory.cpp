@@ -6,6 +6,7 @@
 #include <ecs/components/player_components.h>
 #include <ecs/components/portal_components.h>
 #include <ecs/components/rendering_components.h>
+#include <ecs/components/terrain_components.h>
 #include <ecs/components/turret_component.h>
 #include <ecs/components/weapon_components.h>
 #include <entt/entity/entity.hpp>
@@ -31,12 +32,33 @@ BaseObjectsFactory::BaseObjectsFactory(EnttRegistryWrapper& registryWrapper, Com
 
 entt::entity BaseObjectsFactory::SpawnTile(glm::vec2 posWorld, float sizeWorld, const TextureRect& textureRect, SpawnTileOption tileOptions, const std::string& name)
 {
+    return SpawnTiles({{posWorld, sizeWorld, textureRect}}, tileOptions, name).front();
+}
+
+std::vector<entt::entity> BaseObjectsFactory::SpawnTiles(const std::vector<TileSpawn>& tiles, SpawnTileOption tileOptions, const std::string& name)
+{
+    std::vector<entt::entity> entities;
+    entities.reserve(tiles.size());
+    Box2dBodyOptions options;
+    std::map<float, std::vector<Box2dBodyTuner::BodySpawn>> bodySpawnsBySize;
+    for (const auto& tile : tiles)
+    {
+        auto entity = registryWrapper.Create(name);
+        registry.emplace<TileComponent>(entity, glm::vec2(tile.sizeWorld, tile.sizeWorld), tile.textureRect.texture, tile.textureRect.rect, tileOptions.zOrderingType);
+        options = EmplaceTileTagComponents(entity, tileOptions);
+        entities.push_back(entity);
+        bodySpawnsBySize[tile.sizeWorld].push_back({entity, tile.posWorld, 0.0f});
+    }
+
     auto& gap = utils::GetConfig<float, "ObjectsFactory.gapBetweenPhysicalAndVisual">();
-    glm::vec2 bodySizeWorld(sizeWorld - gap, sizeWorld - gap);
+    for (const auto& [sizeWorld, bodySpawns] : bodySpawnsBySize)
+        box2dBodyCreator.CreatePhysicsBodies(bodySpawns, glm::vec2(sizeWorld - gap, sizeWorld - gap), options);
 
-    auto entity = registryWrapper.Create(name);
-    registry.emplace<TileComponent>(entity, glm::vec2(sizeWorld, sizeWorld), textureRect.texture, textureRect.rect, tileOptions.zOrderingType);
+    return entities;
+}
 
+Box2dBodyOptions BaseObjectsFactory::EmplaceTileTagComponents(entt::entity entity, SpawnTileOption tileOptions)
+{
     Box2dBodyOptions options;
     options.fixture.restitution = 0.05f;
     switch (tileOptions.destructibleOption)
@@ -64,12 +86,78 @@ entt::entity BaseObjectsFactory::SpawnTile(glm::vec2 posWorld, float sizeWorld,
         break;
     }
 
+    return options;
+}
+
+entt::entity BaseObjectsFactory::SpawnTerrain(TerrainComponent terrainComponent, const std::string& name)
+{
+    const auto& mask = terrainComponent.mask;
+    glm::vec2 sizeWorld(mask.GetWidth(), mask.GetHeight());
+    glm::vec2 centerWorld = terrainComponent.originWorld + sizeWorld / 2.0f;
+
+    // Whole mask should be uploaded to the texture and converted to fixtures on the next update.
+    terrainComponent.dirtyRect = mask.GetRect();
+
+    auto entity = registryWrapper.Create(name);
+    registry.emplace<TileComponent>(entity, sizeWorld, terrainComponent.texture, mask.GetRect(), ZOrderingType::Terrain);
+    registry.emplace<CollidableComponent>(entity);
+    registry.emplace<TerrainComponent>(entity, std::move(terrainComponent));
+
+    Box2dBodyOptions options;
+    options.fixture.restitution = 0.05f;
+    options.shape = Box2dBodyOptions::Shape::None;
+    options.dynamic = Box2dBodyOptions::MovementPolicy::Manual;
+    options.anglePolicy = Box2dBodyOptions::AnglePolicy::Fixed;
     float angle = 0.0f;
-    box2dBodyCreator.CreatePhysicsBody(entity, posWorld, bodySizeWorld, angle, options);
+    box2dBodyCreator.CreatePhysicsBody(entity, centerWorld, sizeWorld, angle, options);
 
     return entity;
 }
 
+entt::entity BaseObjectsFactory::SpawnStaticCollider(const std::vector<SDL_FRect>& boxesWorld, const std::string& name)
+{
+    if (boxesWorld.empty())
+        throw std::runtime_error(MY_FMT("[SpawnStaticCollider] No boxes for the collider '{}'", name));
+
+    // Place the body in the center of the bounding box of all boxes.
+    glm::vec2 minWorld(boxesWorld.front().x, boxesWorld.front().y);
+    glm::vec2 maxWorld = minWorld;
+    for (const auto& box : boxesWorld)
+    {
+        minWorld = utils::Vec2Min(minWorld, glm::vec2(box.x, box.y));
+        maxWorld = utils::Vec2Max(maxWorld, glm::vec2(box.x + box.w, box.y + box.h));
+    }
+    glm::vec2 centerWorld = (minWorld + maxWorld) / 2.0f;
+
+    auto entity = registryWrapper.Create(name);
+    registry.emplace<IndestructibleComponent>(entity);
+    registry.emplace<CollidableComponent>(entity);
+
+    Box2dBodyOptions options;
+    options.fixture.restitution = 0.05f;
+    options.shape = Box2dBodyOptions::Shape::None;
+    options.dynamic = Box2dBodyOptions::MovementPolicy::Manual;
+    options.anglePolicy = Box2dBodyOptions::AnglePolicy::Fixed;
+    float angle = 0.0f;
+    box2dBodyCreator.CreatePhysicsBody(entity, centerWorld, maxWorld - minWorld, angle, options);
+
+    for (const auto& box : boxesWorld)
+    {
+        glm::vec2 boxSizeWorld(box.w, box.h);
+        glm::vec2 boxCenterWorld = glm::vec2(box.x, box.y) + boxSizeWorld / 2.0f;
+        bodyTuner.AddBoxFixture(entity, boxCenterWorld - centerWorld, boxSizeWorld);
+    }
+
+    return entity;
+}
+
+entt::entity BaseObjectsFactory::SpawnTileLayer(TileLayerComponent tileLayerComponent, const std::string& name)
+{
+    auto entity = registryWrapper.Create(name);
+    registry.emplace<TileLayerComponent>(entity, std::move(tileLayerComponent));
+    return entity;
+}
+
 entt::entity BaseObjectsFactory::SpawnFragmentAfterExplosion(const glm::vec2& posWorld)
 {
     AnimationComponent fragmentAnimation = componentsFactory.CreateAnimationComponent("explosionFragments", "Fragment[\\d]+", ResourceManager::TagProps::RandomByRegex);
@@ -99,7 +187,7 @@ entt::entity BaseObjectsFactory::SpawnFlyingEntity(
     // Apply the force to the flying entity.
     b2Vec2 speedVec = b2Vec2(initialSpeed, 0);
     speedVec = b2Mul(b2Rot(forceDirection), speedVec);
-    physicsBody.bodyRAII->GetBody()->SetLinearVelocity(speedVec);
+    physicsBody.body->SetLinearVelocity(speedVec);
 
     return flyingEntity;
 }
@@ -173,14 +261,9 @@ entt::entity BaseObjectsFactory::SpawnDebugVisualObject(
 
 entt::entity BaseObjectsFactory::SpawnDebugVisualObject(entt::entity entity, const std::string& nameAsKey, const DebugSpawnOptions& debugSpawnOptions)
 {
-    auto& physicsComponent = registry.get<PhysicsComponent>(entity);
-    auto body = physicsComponent.bodyRAII->GetBody();
-    auto bodyPosPhysics = body->GetPosition();
-    auto bodyAnglePhysics = body->GetAngle();
-    auto sizeWorld = physicsComponent.options.hitbox.sizeWorld;
-
-    auto posWorld = coordinatesTransformer.PhysicsToWorld(bodyPosPhysics);
-    auto newEntity = SpawnDebugVisualObject(posWorld, sizeWorld, bodyAnglePhysics, nameAsKey, debugSpawnOptions);
+    const auto& transform = registry.get<TransformComponent>(entity);
+    auto sizeWorld = registry.get<PhysicsComponent>(entity).options.hitbox.sizeWorld;
+    auto newEntity = SpawnDebugVisualObject(transform.positionWorld, sizeWorld, transform.angle, nameAsKey, debugSpawnOptions);
     return newEntity;
 }
 
@@ -200,47 +283,122 @@ std::vector<entt::entity> BaseObjectsFactory::SpawnFragmentsAfterExplosion(glm::
     return fragments;
 }
 
-std::vector<entt::entity> BaseObjectsFactory::SpawnSplittedPhysicalEnteties(const std::vector<entt::entity>& physicalEntities, SDL_Point cellSizeWorld)
+std::vector<entt::entity> BaseObjectsFactory::SpawnSplittedPhysicalEnteties(
+    const std::vector<entt::entity>& physicalEntities, SDL_Point cellSizeWorld, const glm::vec2& holeCenterWorld, float holeRadiusWorld)
 {
     assert(cellSizeWorld.x == cellSizeWorld.y);
 
-    std::vector<entt::entity> splittedEntities;
+    std::vector<TileSpawn> tilesToSpawn;
 
     for (auto& entity : physicalEntities)
     {
-        if (!registry.all_of<PhysicsComponent, TileComponent>(entity))
+        if (!registry.all_of<TransformComponent, TileComponent>(entity))
             continue;
 
-        auto originalObjPhysicsInfo = registry.get<PhysicsComponent>(entity).bodyRAII->GetBody();
         auto& originalObjRenderingInfo = registry.get<TileComponent>(entity);
-        const b2Vec2& posPhysics = originalObjPhysicsInfo->GetPosition();
-        const glm::vec2 originalObjCenterWorld = coordinatesTransformer.PhysicsToWorld(posPhysics);
+        const glm::vec2 originalObjCenterWorld = registry.get<TransformComponent>(entity).positionWorld;
         const SDL_Rect& originalTextureRect = originalObjRenderingInfo.textureRect;
 
         // Check if the original object is big enough to be splitted.
         if (originalTextureRect.w <= cellSizeWorld.x || originalTextureRect.h <= cellSizeWorld.y)
             continue;
 
-        auto originalRectCenterInTexture = utils::GetCenterOfRect(originalTextureRect);
+        CollectQuadNodesOutsideHole(
+            {originalObjRenderingInfo.texturePtr, originalTextureRect}, originalObjCenterWorld, cellSizeWorld, holeCenterWorld, holeRadiusWorld, tilesToSpawn);
+    }
+
+    return SpawnPixeledTiles(tilesToSpawn);
+}
 
-        auto pixelTextureRects = utils::DivideRectByCellSize(originalTextureRect, cellSizeWorld);
-        for (auto& pixelTextureRect : pixelTextureRects)
+void BaseObjectsFactory::CollectQuadNodesOutsideHole(
+    const TextureRect& nodeTextureRect, const glm::vec2& nodeCenterWorld, SDL_Point cellSizeWorld, const glm::vec2& holeCenterWorld, float holeRadiusWorld,
+    std::vector<TileSpawn>& tilesToSpawn)
+{
+    const SDL_Rect& rect = nodeTextureRect.rect;
+    const glm::vec2 halfSize(rect.w / 2.0f, rect.h / 2.0f);
+    const glm::vec2 delta = glm::abs(nodeCenterWorld - holeCenterWorld);
+    const float nearestDistance = glm::length(glm::max(delta - halfSize, glm::vec2(0.0f)));
+    const float farthestDistance = glm::length(delta + halfSize);
+
+    // Whole node is inside the hole.
+    if (farthestDistance < holeRadiusWorld)
+        return;
+
+    // Whole node is outside the hole. Keep it coarse.
+    if (nearestDistance >= holeRadiusWorld)
+    {
+        tilesToSpawn.push_back({nodeCenterWorld, static_cast<float>(rect.w), nodeTextureRect});
+        return;
+    }
+
+    // Subdivide square nodes to the quadrants while they are bigger than the cell. Other nodes are splitted to the cells.
+    if (rect.w == rect.h && rect.w % 2 == 0 && rect.w / 2 >= cellSizeWorld.x)
+    {
+        const int half = rect.w / 2;
+        for (int quadRow = 0; quadRow < 2; ++quadRow)
         {
-            auto pixelRectCenterInTexture = utils::GetCenterOfRect(pixelTextureRect);
-            auto pixelCenterShift = pixelRectCenterInTexture - originalRectCenterInTexture;
-            glm::vec2 pixelCenterWorld = originalObjCenterWorld + pixelCenterShift;
+            for (int quadCol = 0; quadCol < 2; ++quadCol)
+            {
+                TextureRect quadTextureRect{nodeTextureRect.texture, {rect.x + quadCol * half, rect.y + quadRow * half, half, half}};
+                glm::vec2 quadCenterWorld = nodeCenterWorld + glm::vec2((quadCol - 0.5f) * half, (quadRow - 0.5f) * half);
+                CollectQuadNodesOutsideHole(quadTextureRect, quadCenterWorld, cellSizeWorld, holeCenterWorld, holeRadiusWorld, tilesToSpawn);
+            }
+        }
+        return;
+    }
+
+    CollectCellsOutsideHole(nodeTextureRect, nodeCenterWorld, cellSizeWorld, holeCenterWorld, holeRadiusWorld, tilesToSpawn);
+}
 
-            SpawnTileOption spawnTileOptions;
-            spawnTileOptions.destructibleOption = SpawnTileOption::DesctructibleOption::Destructible;
-            spawnTileOptions.zOrderingType = ZOrderingType::Terrain;
+void BaseObjectsFactory::CollectCellsOutsideHole(
+    const TextureRect& nodeTextureRect, const glm::vec2& nodeCenterWorld, SDL_Point cellSizeWorld, const glm::vec2& holeCenterWorld, float holeRadiusWorld,
+    std::vector<TileSpawn>& tilesToSpawn)
+{
+    const SDL_Rect& rect = nodeTextureRect.rect;
+
+    // Same cell grid as utils::DivideRectByCellSize. Cell (0, 0) is in the top left corner of the texture rect.
+    const int cellsX = rect.w / cellSizeWorld.x;
+    const int cellsY = rect.h / cellSizeWorld.y;
+    const glm::vec2 firstCellCenterWorld =
+        nodeCenterWorld - glm::vec2(rect.w, rect.h) / 2.0f + glm::vec2(cellSizeWorld.x, cellSizeWorld.y) / 2.0f;
 
-            auto pixelEntity = SpawnTile(pixelCenterWorld, cellSizeWorld.x, TextureRect{originalObjRenderingInfo.texturePtr, pixelTextureRect}, spawnTileOptions, "PixeledTile");
+    for (int cellY = 0; cellY < cellsY; ++cellY)
+    {
+        // Cells with the center closer than the radius are destroyed by the explosion, so they are not spawned.
+        // They form the range (holeBeginX, holeEndX) in the row.
+        float cellCenterY = firstCellCenterWorld.y + cellY * cellSizeWorld.y;
+        float dy = cellCenterY - holeCenterWorld.y;
+        float holeHalfWidthSquared = holeRadiusWorld * holeRadiusWorld - dy * dy;
+        float holeBeginX = 0.0f;
+        float holeEndX = 0.0f;
+        if (holeHalfWidthSquared > 0.0f)
+        {
+            float holeHalfWidth = std::sqrt(holeHalfWidthSquared);
+            holeBeginX = (holeCenterWorld.x - holeHalfWidth - firstCellCenterWorld.x) / cellSizeWorld.x;
+            holeEndX = (holeCenterWorld.x + holeHalfWidth - firstCellCenterWorld.x) / cellSizeWorld.x;
+        }
 
-            registry.emplace<PixeledTileComponent>(pixelEntity);
+        for (int cellX = 0; cellX < cellsX; ++cellX)
+        {
+            if (cellX > holeBeginX && cellX < holeEndX)
+                continue;
 
-            splittedEntities.push_back(pixelEntity);
+            TextureRect cellTextureRect{
+                nodeTextureRect.texture, {rect.x + cellX * cellSizeWorld.x, rect.y + cellY * cellSizeWorld.y, cellSizeWorld.x, cellSizeWorld.y}};
+            glm::vec2 cellCenterWorld = firstCellCenterWorld + glm::vec2(cellX * cellSizeWorld.x, cellY * cellSizeWorld.y);
+            tilesToSpawn.push_back({cellCenterWorld, static_cast<float>(cellSizeWorld.x), cellTextureRect});
         }
     }
+}
 
-    return splittedEntities;
+std::vector<entt::entity> BaseObjectsFactory::SpawnPixeledTiles(const std::vector<TileSpawn>& tiles)
+{
+    SpawnTileOption spawnTileOptions;
+    spawnTileOptions.destructibleOption = SpawnTileOption::DesctructibleOption::Destructible;
+    spawnTileOptions.zOrderingType = ZOrderingType::Terrain;
+
+    auto pixelEntities = SpawnTiles(tiles, spawnTileOptions, "PixeledTile");
+    for (auto pixelEntity : pixelEntities)
+        registry.emplace<PixeledTileComponent>(pixelEntity);
+    return pixelEntities;
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 #include <ecs/components/animation_components.h>
 #include <ecs/components/rendering_components.h>
+#include <ecs/components/terrain_components.h>
 #include <entt/entt.hpp>
+#include <map>
 #include <utils/box2d/box2d_body_tuner.h>
 #include <utils/coordinates_transformer.h>
 #include <utils/entt/entt_registry_wrapper.h>
@@ -40,8 +42,23 @@ public:
         size_t trailSize = 10;
         SpawnPolicyBase spawnPolicy = SpawnPolicyBase::This;
     };
+
+    struct TileSpawn
+    {
+        glm::vec2 posWorld;
+        float sizeWorld;
+        TextureRect textureRect;
+    };
 public: ////////////////////////////////////////////// Main game objects. ////////////////////////////////////////
     entt::entity SpawnTile(glm::vec2 posWorld, float sizeWorld, const TextureRect& textureRect, SpawnTileOption tileOptions, const std::string& name = "Tile");
+    // Spawn the tiles with the same options. New bodies of the same size are created in one pass. Return entities in the order of `tiles`.
+    std::vector<entt::entity> SpawnTiles(const std::vector<TileSpawn>& tiles, SpawnTileOption tileOptions, const std::string& name = "Tile");
+    // Spawn the bitmap terrain as one static body. Fixtures are built later by TerrainSystem from the mask.
+    entt::entity SpawnTerrain(TerrainComponent terrainComponent, const std::string& name = "Terrain");
+    // Spawn one static body with box fixtures. Boxes are in the world coordinates. Used for merged indestructible tiles.
+    entt::entity SpawnStaticCollider(const std::vector<SDL_FRect>& boxesWorld, const std::string& name = "StaticCollider");
+    // Spawn render-only tiles of the layer. No physics bodies are created.
+    entt::entity SpawnTileLayer(TileLayerComponent tileLayerComponent, const std::string& name = "TileLayer");
 public: ///////////////////////////////////////// Debug visual objects. //////////////////////////////////////////
     // `nameAsKey` is used as a key in entt registry to search in NameComponent.
     entt::entity SpawnDebugVisualObject(
@@ -50,10 +67,24 @@ public: ///////////////////////////////////////// Debug visual objects. ////////
     entt::entity SpawnDebugVisualObject(entt::entity entity, const std::string& nameAsKey, const DebugSpawnOptions& debugSpawnOptions);
 public: //////////////////////////////////////////////// Explosions. //////////////////////////////////////////////
     // Split physical entities into smaller ones. Return new entities. Used for explosion effect.
-    std::vector<entt::entity> SpawnSplittedPhysicalEnteties(const std::vector<entt::entity>& entities, SDL_Point cellSizeWorld);
+    // Tiles are subdivided as a quadtree only near the hole, down to `cellSizeWorld`. Cells with the center inside the
+    // hole circle are not spawned at all.
+    std::vector<entt::entity> SpawnSplittedPhysicalEnteties(
+        const std::vector<entt::entity>& entities, SDL_Point cellSizeWorld, const glm::vec2& holeCenterWorld, float holeRadiusWorld);
     std::vector<entt::entity> SpawnFragmentsAfterExplosion(glm::vec2 centerWorld, float radiusWorld);
 public: /////////////////////////////////////////// Explosions. Helpers. /////////////////////////////////////////
     entt::entity SpawnFragmentAfterExplosion(const glm::vec2& posWorld);
+    // Collect the nodes to `tilesToSpawn`. They are spawned together by SpawnPixeledTiles.
+    void CollectQuadNodesOutsideHole(
+        const TextureRect& nodeTextureRect, const glm::vec2& nodeCenterWorld, SDL_Point cellSizeWorld, const glm::vec2& holeCenterWorld, float holeRadiusWorld,
+        std::vector<TileSpawn>& tilesToSpawn);
+    void CollectCellsOutsideHole(
+        const TextureRect& nodeTextureRect, const glm::vec2& nodeCenterWorld, SDL_Point cellSizeWorld, const glm::vec2& holeCenterWorld, float holeRadiusWorld,
+        std::vector<TileSpawn>& tilesToSpawn);
+    std::vector<entt::entity> SpawnPixeledTiles(const std::vector<TileSpawn>& tiles);
+public: /////////////////////////////////////////////// Tiles. Helpers. ////////////////////////////////////////////
+    // Emplace the tag components of the tile. Return the body options of the tile.
+    Box2dBodyOptions EmplaceTileTagComponents(entt::entity entity, SpawnTileOption tileOptions);
 public: ///////////////////////////////////////////// Common. Helpers. ///////////////////////////////////////////
     entt::entity SpawnFlyingEntity(const glm::vec2& posWorld, const glm::vec2& sizeWorld, float forceDirection, float force, Box2dBodyOptions::AnglePolicy anglePolicy);
 };
\ No newline at end of file
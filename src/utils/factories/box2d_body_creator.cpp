@@ -15,4 +15,10 @@ PhysicsComponent& Box2dBodyCreator::CreatePhysicsBody(entt::entity entity, const
 {
     options.hitbox.sizeWorld = sizeWorld;
     return bodyTuner.CreatePhysicsComponent(entity, posWorld, angle, options);
-}
\ No newline at end of file
+}
+
+void Box2dBodyCreator::CreatePhysicsBodies(std::span<const Box2dBodyTuner::BodySpawn> spawns, const glm::vec2& sizeWorld, Box2dBodyOptions options)
+{
+    options.hitbox.sizeWorld = sizeWorld;
+    bodyTuner.CreatePhysicsComponents(spawns, options);
+}
@@ -2,7 +2,7 @@
 #include "entt/entity/fwd.hpp"
 #include "utils/box2d/box2d_body_tuner.h"
 #include <ecs/components/physics_components.h>
-#include <utils/box2d/box2d_RAII.h>
+#include <span>
 #include <utils/box2d/box2d_body_options.h>
 #include <utils/coordinates_transformer.h>
 #include <utils/game_options.h>
@@ -17,4 +17,6 @@ public:
     PhysicsComponent& CreatePhysicsBody(entt::entity entity, const glm::vec2& posWorld, float angle, const Box2dBodyOptions& options);
     // Overwrite size of object in options.hitbox.sizeWorld with sizeWorld.
     PhysicsComponent& CreatePhysicsBody(entt::entity entity, const glm::vec2& posWorld, const glm::vec2& sizeWorld, float angle, Box2dBodyOptions options);
+    // Overwrite size of objects in options.hitbox.sizeWorld with sizeWorld. Options are compiled once for all bodies.
+    void CreatePhysicsBodies(std::span<const Box2dBodyTuner::BodySpawn> spawns, const glm::vec2& sizeWorld, Box2dBodyOptions options);
 };
\ No newline at end of file
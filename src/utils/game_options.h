@@ -4,7 +4,9 @@
 #include <memory>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <utils/box2d/box2d_body_pool.h>
 #include <utils/sdl/sdl_RAII.h>
+#include <utils/task_scheduler.h>
 
 struct LevelPhysicsBounds
 {
@@ -45,6 +47,11 @@ struct ControlOptions
     bool showGameOverScreen{false};
 };
 
+struct PhysicsOptions
+{
+    float interpolationAlpha{1.0f}; // Part of the fixed physics step accumulated since the last step. In range [0, 1).
+};
+
 struct DebugInfo
 {
     float spacePressedDuration{0.0f};
@@ -54,9 +61,12 @@ struct DebugInfo
 struct GameOptions
 {
     std::shared_ptr<b2World> physicsWorld;
+    std::shared_ptr<Box2dBodyPool> bodyPool; // Recreated together with the physicsWorld.
+    std::shared_ptr<TaskScheduler> taskScheduler; // Workers for the terrain contour extraction. Created once.
     LevelOptions levelOptions;
     WindowOptions windowOptions;
     ControlOptions controlOptions;
+    PhysicsOptions physicsOptions;
     DebugInfo debugInfo;
     b2Vec2 gravity{0.0f, +9.8f};
     bool showGameInstructions{true};
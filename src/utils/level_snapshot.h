@@ -0,0 +1,56 @@
+#pragma once
+#include <SDL.h>
+#include <ecs/components/rendering_components.h>
+#include <ecs/components/terrain_components.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <utils/factories/base_objects_factory.h>
+#include <utils/game_options.h>
+#include <variant>
+#include <vector>
+
+// Level baked by MapLoaderSystem on the first load. Reloads of the level replay the steps without reading the map file
+// and scanning the tileset. The steps keep the order of the first load, so the entities are spawned in the same order.
+struct LevelSnapshot
+{
+    struct TileBatch
+    {
+        SpawnTileOption tileOptions;
+        std::vector<BaseObjectsFactory::TileSpawn> tiles;
+    };
+
+    struct TileLayer
+    {
+        TileLayerComponent tileLayer;
+        std::string name;
+    };
+
+    struct StaticCollider
+    {
+        std::vector<SDL_FRect> boxesWorld;
+        std::string name;
+    };
+
+    // Texture of the terrain is not baked. The mask is modified by the explosions, so each load creates a new one.
+    struct Terrain
+    {
+        TerrainComponent terrain;
+    };
+
+    struct Object
+    {
+        enum class Type
+        {
+            Player,
+            Portal,
+            Turret,
+        } type;
+        std::string name;
+        glm::vec2 posWorld;
+    };
+
+    using Step = std::variant<TileBatch, TileLayer, StaticCollider, Terrain, Object>;
+
+    std::vector<Step> steps;
+    LevelPhysicsBounds levelBox2dBounds; // Including the buffer zone.
+};
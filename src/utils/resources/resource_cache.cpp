@@ -46,9 +46,18 @@ std::shared_ptr<SDLTextureRAII> ResourceCache::LoadTexture(const std::filesystem
 
     MY_LOG(debug, "Loading texture: {}", filePath.string());
 
-    // Load the texture and cache it.
+    // Load the texture and cache it. In the headless mode the texture is empty but unique per file, so textures may
+    // still be compared. The surface is loaded instead because the game logic reads sizes and pixels from it.
     std::shared_ptr<SDLTextureRAII> textureRAII;
-    textureRAII = details::LoadTexture(renderer, absolutePath);
+    if (renderer)
+    {
+        textureRAII = details::LoadTexture(renderer, absolutePath);
+    }
+    else
+    {
+        LoadSurface(absolutePath);
+        textureRAII = std::make_shared<SDLTextureRAII>();
+    }
     textures[absolutePath] = textureRAII;
     return textureRAII;
 }
@@ -95,9 +104,29 @@ std::shared_ptr<SDLSurfaceRAII> ResourceCache::LoadSurface(const std::filesystem
     // Load the surface and cache it.
     std::shared_ptr<SDLSurfaceRAII> surfaceRAII = details::LoadSurfaceWithStreamingAccess(absolutePath);
     surfaces[absolutePath] = surfaceRAII;
+    surfaceAlphaTables[absolutePath] = std::make_shared<SDLAlphaTable>(surfaceRAII->get());
     return surfaceRAII;
 }
 
+std::shared_ptr<SDLAlphaTable> ResourceCache::LoadSurfaceAlphaTable(const std::filesystem::path& filePath)
+{
+    LoadSurface(filePath);
+    return surfaceAlphaTables[std::filesystem::absolute(filePath)];
+}
+
+std::shared_ptr<SDLTextureRAII> ResourceCache::CreateStreamingTexture(int width, int height)
+{
+    if (!renderer)
+        return nullptr;
+
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (!texture)
+        throw std::runtime_error(MY_FMT("[CreateStreamingTexture] Failed to create texture {}x{}: {}", width, height, SDL_GetError()));
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return std::make_shared<SDLTextureRAII>(texture);
+}
+
 std::shared_ptr<SDLTextureRAII> ResourceCache::GetColoredPixelTexture(const ColorName& color)
 {
     // Return cached texture if it was already loaded.
@@ -105,7 +134,8 @@ std::shared_ptr<SDLTextureRAII> ResourceCache::GetColoredPixelTexture(const Colo
         return coloredTextures[color];
 
     // Create texture with the specified color and cache it.
-    std::shared_ptr<SDLTextureRAII> textureRAII = std::make_shared<SDLTextureRAII>(details::GetColoredPixelTexture(renderer, color));
+    std::shared_ptr<SDLTextureRAII> textureRAII =
+        renderer ? std::make_shared<SDLTextureRAII>(details::GetColoredPixelTexture(renderer, color)) : std::make_shared<SDLTextureRAII>();
     coloredTextures[color] = textureRAII;
     return textureRAII;
 }
@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <memory>
 #include <unordered_map>
+#include <utils/sdl/sdl_alpha_table.h>
 #include <utils/sdl/sdl_RAII.h>
 #include <utils/sdl/sdl_audio_RAII.h>
 #include <utils/sdl/sdl_colors.h>
@@ -14,13 +15,18 @@ namespace details
 class ResourceCache
 {
 public:
+    // `renderer` is nullptr in the headless mode. Then textures are empty and only the surfaces are loaded.
     explicit ResourceCache(SDL_Renderer* renderer);
 
     std::shared_ptr<SDLTextureRAII> GetColoredPixelTexture(const ColorName& color);
     std::shared_ptr<SDLTextureRAII> LoadTexture(const std::filesystem::path& filePath);
+    // Alpha table of the surface is built once together with the surface.
     std::shared_ptr<SDLSurfaceRAII> LoadSurface(const std::filesystem::path& filePath);
+    std::shared_ptr<SDLAlphaTable> LoadSurfaceAlphaTable(const std::filesystem::path& filePath);
     std::shared_ptr<MusicRAII> LoadMusic(const std::filesystem::path& filePath);
     std::shared_ptr<SoundEffectRAII> LoadSoundEffect(const std::filesystem::path& filePath);
+    // Create a new (not cached) ABGR8888 texture with streaming access and alpha blending. Return nullptr in the headless mode.
+    std::shared_ptr<SDLTextureRAII> CreateStreamingTexture(int width, int height);
 private:
     SDL_Renderer* renderer;
 
@@ -28,6 +34,7 @@ private:
     std::unordered_map<ColorName, std::shared_ptr<SDLTextureRAII>> coloredTextures;
     std::unordered_map<std::filesystem::path, std::shared_ptr<SDLTextureRAII>> textures;
     std::unordered_map<std::filesystem::path, std::shared_ptr<SDLSurfaceRAII>> surfaces;
+    std::unordered_map<std::filesystem::path, std::shared_ptr<SDLAlphaTable>> surfaceAlphaTables;
     std::unordered_map<std::filesystem::path, std::shared_ptr<MusicRAII>> musics;
     std::unordered_map<std::filesystem::path, std::shared_ptr<SoundEffectRAII>> soundEffects;
 };
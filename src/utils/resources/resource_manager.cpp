@@ -172,8 +172,8 @@ ResourceManager::TagToAnimationDict ResourceManager::ReadAsepriteAnimation(const
     // Load texture.
     auto animationTexturePath = asepriteAnimationJsonPath.parent_path() / asepriteData.texturePath;
     std::shared_ptr<SDLTextureRAII> textureRAII = resourceCashe.LoadTexture(animationTexturePath);
-    // Surface with sreaming access is needed to get hitbox rect.
-    std::shared_ptr<SDLSurfaceRAII> surfaceRAII = resourceCashe.LoadSurface(animationTexturePath);
+    // Alpha table of the surface is needed to get hitbox rect.
+    std::shared_ptr<SDLAlphaTable> alphaTable = resourceCashe.LoadSurfaceAlphaTable(animationTexturePath);
 
     TagToAnimationDict tagToAnimationDict;
 
@@ -183,7 +183,9 @@ ResourceManager::TagToAnimationDict ResourceManager::ReadAsepriteAnimation(const
         if (asepriteData.frameTags.contains("Hitbox"))
         {
             const SDL_Rect& rectInSurface = asepriteData.frames[asepriteData.frameTags["Hitbox"].from].rectInTexture;
-            hitboxRect = GetVisibleRectInSrcRectCoordinates(surfaceRAII->get(), rectInSurface);
+            hitboxRect = alphaTable->GetVisibleRect(rectInSurface);
+            hitboxRect->x -= rectInSurface.x;
+            hitboxRect->y -= rectInSurface.y;
             MY_LOG(debug, "Hitbox rect found: x={}, y={}, w={}, h={}", hitboxRect->x, hitboxRect->y, hitboxRect->w, hitboxRect->h);
         }
 
@@ -275,7 +277,17 @@ std::shared_ptr<SDLSurfaceRAII> ResourceManager::GetSurface(const std::filesyste
     return resourceCashe.LoadSurface(path);
 }
 
+std::shared_ptr<SDLAlphaTable> ResourceManager::GetSurfaceAlphaTable(const std::filesystem::path& path)
+{
+    return resourceCashe.LoadSurfaceAlphaTable(path);
+}
+
 std::shared_ptr<SDLTextureRAII> ResourceManager::GetColoredPixelTexture(ColorName color)
 {
     return resourceCashe.GetColoredPixelTexture(color);
+}
+
+std::shared_ptr<SDLTextureRAII> ResourceManager::CreateStreamingTexture(int width, int height)
+{
+    return resourceCashe.CreateStreamingTexture(width, height);
 }
\ No newline at end of file
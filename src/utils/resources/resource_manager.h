@@ -51,6 +51,7 @@ private:
     std::unordered_map<FriendlyName, std::filesystem::path> musicPaths;
     std::unordered_map<std::string, std::vector<SoundEffectBatch>> soundEffectBatchesPerTag;
 public:
+    // `renderer` is nullptr in the headless mode. Textures are empty then, surfaces and other resources are loaded as usual.
     ResourceManager(SDL_Renderer* renderer, const nlohmann::json& assetsSettingsJson);
 public: // //////////////////////////////////////// Animations ////////////////////////////////////////
     enum class TagProps
@@ -71,6 +72,10 @@ public: // ////////////////////////////////////////// Textures /////////////////
     std::shared_ptr<SDLTextureRAII> GetColoredPixelTexture(ColorName color);
     std::shared_ptr<SDLTextureRAII> GetTexture(const std::filesystem::path& path);
     std::shared_ptr<SDLSurfaceRAII> GetSurface(const std::filesystem::path& path);
+    // Precomputed visibility of the pixels of the surface. Used instead of scanning the surface pixels.
+    std::shared_ptr<SDLAlphaTable> GetSurfaceAlphaTable(const std::filesystem::path& path);
+    // Create a new texture which content is updated by the game (e.g. destructible terrain).
+    std::shared_ptr<SDLTextureRAII> CreateStreamingTexture(int width, int height);
 public: // /////////////////////////////////////////// Sounds ///////////////////////////////////////////
     std::shared_ptr<MusicRAII> GetMusic(const std::string& name);
     SoundEffectInfo GetSoundEffect(const std::string& name);
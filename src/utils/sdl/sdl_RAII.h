@@ -47,6 +47,7 @@ class SDLTextureRAII
 {
     SDL_Texture* texture = nullptr;
 public:
+    SDLTextureRAII() = default; // Empty texture. Used in the headless mode where nothing is rendered.
     SDLTextureRAII(SDL_Texture* texture);
     ~SDLTextureRAII();
     SDLTextureRAII(const SDLTextureRAII&) = delete;
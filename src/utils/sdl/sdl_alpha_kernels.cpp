@@ -0,0 +1,148 @@
+#include "sdl_alpha_kernels.h"
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace utils
+{
+
+namespace scalar
+{
+
+bool AnyAlpha(const Uint32* pixels, int count, Uint32 alphaMask)
+{
+    for (int i = 0; i < count; ++i)
+        if (pixels[i] & alphaMask)
+            return true;
+    return false;
+}
+
+int CountAlpha(const Uint32* pixels, int count, Uint32 alphaMask)
+{
+    int result = 0;
+    for (int i = 0; i < count; ++i)
+        result += (pixels[i] & alphaMask) != 0;
+    return result;
+}
+
+} // namespace scalar
+
+#if defined(__AVX2__)
+
+namespace
+{
+
+constexpr int blockSize = 8; // Pixels in the register.
+
+} // namespace
+
+bool AnyAlpha(const Uint32* pixels, int count, Uint32 alphaMask)
+{
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>(alphaMask));
+    int i = 0;
+    // Two registers per iteration: 16 pixels.
+    for (; i + 2 * blockSize <= count; i += 2 * blockSize)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i + blockSize));
+        if (!_mm256_testz_si256(_mm256_or_si256(a, b), mask))
+            return true;
+    }
+    return scalar::AnyAlpha(pixels + i, count - i, alphaMask);
+}
+
+int CountAlpha(const Uint32* pixels, int count, Uint32 alphaMask)
+{
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>(alphaMask));
+    __m256i zeroCounts = _mm256_setzero_si256(); // Comparison result is -1 for the pixels with zero alpha.
+    int i = 0;
+    for (; i + blockSize <= count; i += blockSize)
+    {
+        __m256i alpha = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i)), mask);
+        zeroCounts = _mm256_sub_epi32(zeroCounts, _mm256_cmpeq_epi32(alpha, _mm256_setzero_si256()));
+    }
+
+    alignas(32) int lanes[blockSize];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), zeroCounts);
+    int zeroAlphaNumber = 0;
+    for (int lane : lanes)
+        zeroAlphaNumber += lane;
+
+    return (i - zeroAlphaNumber) + scalar::CountAlpha(pixels + i, count - i, alphaMask);
+}
+
+const char* GetAlphaKernelsName()
+{
+    return "AVX2";
+}
+
+#elif defined(__SSE2__)
+
+namespace
+{
+
+constexpr int blockSize = 4; // Pixels in the register.
+
+} // namespace
+
+bool AnyAlpha(const Uint32* pixels, int count, Uint32 alphaMask)
+{
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(alphaMask));
+    int i = 0;
+    // Four registers per iteration: 16 pixels.
+    for (; i + 4 * blockSize <= count; i += 4 * blockSize)
+    {
+        const __m128i* block = reinterpret_cast<const __m128i*>(pixels + i);
+        __m128i any = _mm_or_si128(_mm_or_si128(_mm_loadu_si128(block), _mm_loadu_si128(block + 1)), _mm_or_si128(_mm_loadu_si128(block + 2), _mm_loadu_si128(block + 3)));
+        __m128i alpha = _mm_and_si128(any, mask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, _mm_setzero_si128())) != 0xFFFF)
+            return true;
+    }
+    return scalar::AnyAlpha(pixels + i, count - i, alphaMask);
+}
+
+int CountAlpha(const Uint32* pixels, int count, Uint32 alphaMask)
+{
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(alphaMask));
+    __m128i zeroCounts = _mm_setzero_si128(); // Comparison result is -1 for the pixels with zero alpha.
+    int i = 0;
+    for (; i + blockSize <= count; i += blockSize)
+    {
+        __m128i alpha = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i)), mask);
+        zeroCounts = _mm_sub_epi32(zeroCounts, _mm_cmpeq_epi32(alpha, _mm_setzero_si128()));
+    }
+
+    alignas(16) int lanes[blockSize];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), zeroCounts);
+    int zeroAlphaNumber = 0;
+    for (int lane : lanes)
+        zeroAlphaNumber += lane;
+
+    return (i - zeroAlphaNumber) + scalar::CountAlpha(pixels + i, count - i, alphaMask);
+}
+
+const char* GetAlphaKernelsName()
+{
+    return "SSE2";
+}
+
+#else
+
+bool AnyAlpha(const Uint32* pixels, int count, Uint32 alphaMask)
+{
+    return scalar::AnyAlpha(pixels, count, alphaMask);
+}
+
+int CountAlpha(const Uint32* pixels, int count, Uint32 alphaMask)
+{
+    return scalar::CountAlpha(pixels, count, alphaMask);
+}
+
+const char* GetAlphaKernelsName()
+{
+    return "Scalar";
+}
+
+#endif
+
+} // namespace utils
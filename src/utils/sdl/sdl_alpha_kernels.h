@@ -0,0 +1,25 @@
+#pragma once
+#include <SDL.h>
+
+// Kernels to scan the rows of 32-bit pixels for non-zero alpha. Alpha bits are selected by `alphaMask`
+// (e.g. `surface->format->Amask`). SSE2/AVX2 versions are used if they are enabled for the target, otherwise scalar.
+// Used by TerrainMask. Timings against the scalar loops: `alpha_kernels_benchmark` target in the `bench` directory.
+namespace utils
+{
+
+// Check if at least one pixel of the row has non-zero alpha.
+bool AnyAlpha(const Uint32* pixels, int count, Uint32 alphaMask);
+// Count pixels of the row with non-zero alpha.
+int CountAlpha(const Uint32* pixels, int count, Uint32 alphaMask);
+// Name of the instruction set used by the kernels: "AVX2", "SSE2" or "Scalar".
+const char* GetAlphaKernelsName();
+
+namespace scalar
+{
+
+bool AnyAlpha(const Uint32* pixels, int count, Uint32 alphaMask);
+int CountAlpha(const Uint32* pixels, int count, Uint32 alphaMask);
+
+} // namespace scalar
+
+} // namespace utils
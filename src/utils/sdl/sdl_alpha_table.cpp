@@ -0,0 +1,79 @@
+#include "sdl_alpha_table.h"
+#include <stdexcept>
+#include <utils/sdl/sdl_RAII.h>
+
+SDLAlphaTable::SDLAlphaTable(SDL_Surface* surface)
+{
+    if (!surface)
+        throw std::runtime_error("[SDLAlphaTable] Surface is NULL");
+
+    if (surface->format->BytesPerPixel != 4)
+        throw std::runtime_error("[SDLAlphaTable] Only 32-bit surfaces are supported");
+
+    width = surface->w;
+    height = surface->h;
+    sums.assign((width + 1) * (height + 1), 0);
+
+    SDLSurfaceLockRAII lock(surface);
+    const Uint32* pixels = static_cast<const Uint32*>(surface->pixels);
+    int pitch = surface->pitch / 4; // pitch is in bytes, so divide by 4 to get the number of pixels.
+    const Uint32 alphaMask = surface->format->Amask;
+
+    for (int y = 0; y < height; ++y)
+    {
+        int rowSum = 0;
+        for (int x = 0; x < width; ++x)
+        {
+            rowSum += (pixels[y * pitch + x] & alphaMask) != 0;
+            sums[(y + 1) * (width + 1) + x + 1] = Sum(x + 1, y) + rowSum;
+        }
+    }
+}
+
+int SDLAlphaTable::CountVisible(const SDL_Rect& rect) const
+{
+    SDL_Rect clipped = ClipRect(rect);
+    if (SDL_RectEmpty(&clipped))
+        return 0;
+
+    int x0 = clipped.x;
+    int y0 = clipped.y;
+    int x1 = clipped.x + clipped.w;
+    int y1 = clipped.y + clipped.h;
+    return Sum(x1, y1) - Sum(x0, y1) - Sum(x1, y0) + Sum(x0, y0);
+}
+
+SDL_Rect SDLAlphaTable::GetVisibleRect(const SDL_Rect& rect) const
+{
+    SDL_Rect clipped = ClipRect(rect);
+    if (CountVisible(clipped) == 0)
+        return {0, 0, 0, 0};
+
+    // Every row and column is checked in O(1). The loops stop on the first visible one.
+    int minY = clipped.y;
+    while (CountVisible({clipped.x, minY, clipped.w, 1}) == 0)
+        ++minY;
+
+    int maxY = clipped.y + clipped.h - 1;
+    while (CountVisible({clipped.x, maxY, clipped.w, 1}) == 0)
+        --maxY;
+
+    int minX = clipped.x;
+    while (CountVisible({minX, minY, 1, maxY - minY + 1}) == 0)
+        ++minX;
+
+    int maxX = clipped.x + clipped.w - 1;
+    while (CountVisible({maxX, minY, 1, maxY - minY + 1}) == 0)
+        --maxX;
+
+    return {minX, minY, maxX - minX + 1, maxY - minY + 1};
+}
+
+SDL_Rect SDLAlphaTable::ClipRect(const SDL_Rect& rect) const
+{
+    SDL_Rect surfaceRect{0, 0, width, height};
+    SDL_Rect clipped;
+    if (!SDL_IntersectRect(&rect, &surfaceRect, &clipped))
+        return {0, 0, 0, 0};
+    return clipped;
+}
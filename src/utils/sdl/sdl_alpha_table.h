@@ -0,0 +1,24 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// Summed-area table of the visible pixels (alpha > 0) of the surface. Built once when the surface is loaded.
+// "Is the rect invisible" is O(1), the visible bounds of the rect are found in O(w + h).
+// Coordinates are in pixels of the surface. Rects are clipped by the surface.
+class SDLAlphaTable
+{
+    int width = 0;
+    int height = 0;
+    std::vector<int> sums; // (width + 1) * (height + 1). Number of visible pixels in the rect [0, x) x [0, y).
+public:
+    explicit SDLAlphaTable(SDL_Surface* surface);
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    int CountVisible(const SDL_Rect& rect) const;
+    bool IsInvisible(const SDL_Rect& rect) const { return CountVisible(rect) == 0; }
+    // Bounding rect of the visible pixels in the surface coordinates. Return empty rect if there are no visible pixels.
+    SDL_Rect GetVisibleRect(const SDL_Rect& rect) const;
+private:
+    int Sum(int x, int y) const { return sums[y * (width + 1) + x]; }
+    SDL_Rect ClipRect(const SDL_Rect& rect) const;
+};
@@ -1,6 +1,7 @@
 #include "sdl_primitives_renderer.h"
 #include <glm/fwd.hpp>
 #include <numbers>
+#include <utils/logger.h>
 #include <utils/sdl/sdl_colors.h>
 #include <utils/sdl/sdl_gfx_wrapper.h>
 #include <utils/sdl/sdl_utils.h>
@@ -58,6 +59,27 @@ void SdlPrimitivesRenderer::RenderTile(const TileComponent& tileInfo, const glm:
     SDL_RenderCopyEx(renderer, tileInfo.texturePtr->get(), &tileInfo.textureRect, &destRect, angleDegrees, &center, flip);
 }
 
+void SdlPrimitivesRenderer::RenderTileLayer(const TileLayerComponent& tileLayer)
+{
+    if (!tileLayer.texturePtr)
+        return;
+
+    // Skip tiles outside of the camera view.
+    const auto& rOpt = gameState.windowOptions;
+    glm::vec2 halfViewWorld = rOpt.windowSize / (2.0f * rOpt.cameraScale) + tileLayer.tileSizeWorld;
+    glm::vec2 viewMin = rOpt.cameraCenterSdl - halfViewWorld;
+    glm::vec2 viewMax = rOpt.cameraCenterSdl + halfViewWorld;
+
+    for (const auto& tile : tileLayer.tiles)
+    {
+        if (tile.centerWorld.x < viewMin.x || tile.centerWorld.x > viewMax.x || tile.centerWorld.y < viewMin.y || tile.centerWorld.y > viewMax.y)
+            continue;
+
+        SDL_Rect destRect = GetRectWithCameraTransform(tile.centerWorld, tileLayer.tileSizeWorld);
+        SDL_RenderCopy(renderer, tileLayer.texturePtr->get(), &tile.textureRect, &destRect);
+    }
+}
+
 void SdlPrimitivesRenderer::RenderAnimationComponent(const AnimationComponent& animationInfo, glm::vec2 centerWorld, float angle)
 {
     if (animationInfo.animation.frames.empty())
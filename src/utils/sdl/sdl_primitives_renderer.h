@@ -4,7 +4,6 @@
 #include <ecs/components/animation_components.h>
 #include <ecs/components/rendering_components.h>
 #include <entt/entt.hpp>
-#include <utils/box2d/box2d_RAII.h>
 #include <utils/coordinates_transformer.h>
 #include <utils/game_options.h>
 #include <utils/resources/resource_manager.h>
@@ -21,6 +20,7 @@ public:
     void RenderRect(const glm::vec2& posWorld, const glm::vec2& sizeWorld, float angle, ColorName color);
     void RenderCircle(const glm::vec2& centerWorld, float radiusWorld, ColorName color);
     void RenderTile(const TileComponent& tileInfo, const glm::vec2& centerWorld, const float angle, const SDL_RendererFlip& flip = SDL_FLIP_NONE);
+    void RenderTileLayer(const TileLayerComponent& tileLayer);
     void RenderAnimationComponent(const AnimationComponent& animationInfo, glm::vec2 centerWorld, float angle);
     void RenderAnimationFirstFrame(const Animation& animation, glm::vec2 centerWorld, float angle, const SDL_RendererFlip& flip = SDL_FLIP_NONE);
     void RenderBackground(const BackgroundInfo& backgroundInfo);
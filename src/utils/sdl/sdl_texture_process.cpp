@@ -5,38 +5,12 @@
 #include <utils/logger.h>
 #include <utils/sdl/sdl_RAII.h>
 
-bool IsTileInvisible(SDL_Surface* surface, const SDL_Rect& miniTextureSrcRect)
+SDL_Rect CalculateSrcRect(int tileId, int tileWidth, int tileHeight, SDL_Surface* tilesetSurface)
 {
-    if (!surface)
-        throw std::runtime_error("[IsTileInvisible] Surface is NULL");
+    if (!tilesetSurface)
+        throw std::runtime_error("[CalculateSrcRect] Surface is NULL");
 
-    SDLSurfaceLockRAII lock(surface);
-
-    Uint32* pixels = static_cast<Uint32*>(surface->pixels);
-    int pitch = surface->pitch;
-
-    for (int row = 0; row < miniTextureSrcRect.h; ++row)
-    {
-        for (int col = 0; col < miniTextureSrcRect.w; ++col)
-        {
-            Uint32 pixel = pixels[(miniTextureSrcRect.y + row) * (pitch / 4) + (miniTextureSrcRect.x + col)];
-            Uint8 alpha = (pixel >> surface->format->Ashift) & 0xFF;
-            if (alpha > 0)
-            {
-                return false;
-            }
-        }
-    }
-
-    return true;
-}
-
-SDL_Rect CalculateSrcRect(int tileId, int tileWidth, int tileHeight, std::shared_ptr<SDLTextureRAII> texture)
-{
-    int textureWidth, textureHeight;
-    SDL_QueryTexture(texture->get(), nullptr, nullptr, &textureWidth, &textureHeight);
-
-    int tilesPerRow = textureWidth / tileWidth;
+    int tilesPerRow = tilesetSurface->w / tileWidth;
     tileId -= 1; // Adjust tileId to match 0-based indexing. Tiled uses 1-based indexing.
 
     SDL_Rect srcRect;
@@ -48,55 +22,6 @@ SDL_Rect CalculateSrcRect(int tileId, int tileWidth, int tileHeight, std::shared
     return srcRect;
 }
 
-SDL_Rect GetVisibleRectInSurfaceCoordinates(SDL_Surface* surface, const SDL_Rect& textureSrcRect)
-{
-    if (!surface)
-        throw std::runtime_error("[GetVisibleRect] Surface is NULL");
-
-    SDLSurfaceLockRAII lock(surface);
-    Uint32* pixels = static_cast<Uint32*>(surface->pixels);
-    int pitch = surface->pitch / 4; // pitch is in bytes, so divide by 4 to get the number of pixels.
-
-    int minX = std::numeric_limits<int>::max();
-    int minY = std::numeric_limits<int>::max();
-    int maxX = 0;
-    int maxY = 0;
-
-    for (int row = 0; row < textureSrcRect.h; ++row)
-    {
-        for (int col = 0; col < textureSrcRect.w; ++col)
-        {
-            Uint32 pixel = pixels[(textureSrcRect.y + row) * pitch + (textureSrcRect.x + col)];
-            Uint8 alpha = (pixel >> surface->format->Ashift) & 0xFF;
-
-            if (alpha > 0)
-            {
-                minX = std::min(minX, col + textureSrcRect.x);
-                maxX = std::max(maxX, col + textureSrcRect.x);
-                minY = std::min(minY, row + textureSrcRect.y);
-                maxY = std::max(maxY, row + textureSrcRect.y);
-            }
-        }
-    }
-
-    if (minX == std::numeric_limits<int>::max())
-    {
-        // No visible pixels found.
-        return {0, 0, 0, 0};
-    }
-
-    SDL_Rect visibleRect = {minX, minY, maxX - minX + 1, maxY - minY + 1};
-    return visibleRect;
-}
-
-SDL_Rect GetVisibleRectInSrcRectCoordinates(SDL_Surface* surface, const SDL_Rect& textureSrcRect)
-{
-    SDL_Rect visibleRect = GetVisibleRectInSurfaceCoordinates(surface, textureSrcRect);
-    visibleRect.x -= textureSrcRect.x;
-    visibleRect.y -= textureSrcRect.y;
-    return visibleRect;
-}
-
 namespace details
 {
 
@@ -10,16 +10,9 @@ struct TextureRect
     SDL_Rect rect; // Rectangle in the texture corresponding to the tile.
 };
 
-bool IsTileInvisible(SDL_Surface* surface, const SDL_Rect& miniTextureSrcRect);
-
 // TileId is 1-based. Tiled uses 1-based indexing.
-SDL_Rect CalculateSrcRect(int tileId, int tileWidth, int tileHeight, std::shared_ptr<SDLTextureRAII> texture);
-
-// Function to get the visible rectangle of a surface in coordinates of the surface.
-SDL_Rect GetVisibleRectInSurfaceCoordinates(SDL_Surface* surface, const SDL_Rect& textureSrcRect);
-
-// Function to get the visible rectangle of a surface in coordinates of the srcRect.
-SDL_Rect GetVisibleRectInSrcRectCoordinates(SDL_Surface* surface, const SDL_Rect& textureSrcRect);
+// Size of the tileset is taken from the surface. So it works in the headless mode where textures are empty.
+SDL_Rect CalculateSrcRect(int tileId, int tileWidth, int tileHeight, SDL_Surface* tilesetSurface);
 
 namespace details
 {
@@ -64,4 +64,45 @@ void RotatePoint(glm::vec2& point, const glm::vec2& center, float angleRadians)
     point.x = xnew + center.x;
     point.y = ynew + center.y;
 }
-} // namespace utils
\ No newline at end of file
+std::vector<SDL_Rect> MergeCellsToRects(const std::vector<bool>& solidCells, int cols, int rows)
+{
+    std::vector<SDL_Rect> rects;
+    std::vector<bool> usedCells(solidCells.size(), false);
+    auto isFree = [&](int col, int row) { return solidCells[row * cols + col] && !usedCells[row * cols + col]; };
+
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int col = 0; col < cols; ++col)
+        {
+            if (!isFree(col, row))
+                continue;
+
+            // Extend the rect to the right as far as possible.
+            int width = 1;
+            while (col + width < cols && isFree(col + width, row))
+                ++width;
+
+            // Extend the rect down while the whole row span is free.
+            int height = 1;
+            while (row + height < rows)
+            {
+                bool isRowFree = true;
+                for (int x = col; x < col + width && isRowFree; ++x)
+                    isRowFree = isFree(x, row + height);
+                if (!isRowFree)
+                    break;
+                ++height;
+            }
+
+            for (int y = row; y < row + height; ++y)
+                for (int x = col; x < col + width; ++x)
+                    usedCells[y * cols + x] = true;
+
+            rects.push_back({col, row, width, height});
+        }
+    }
+
+    return rects;
+}
+
+} // namespace utils
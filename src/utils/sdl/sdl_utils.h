@@ -16,4 +16,7 @@ std::vector<SDL_Rect> DivideRectByCellSize(const SDL_Rect& rect, const SDL_Point
 
 void RotatePoint(glm::vec2& point, const glm::vec2& center, float angleRadians);
 
+// Greedily merge solid cells of the row-major grid into maximal rectangles. Rects are in cell units.
+std::vector<SDL_Rect> MergeCellsToRects(const std::vector<bool>& solidCells, int cols, int rows);
+
 } // namespace utils
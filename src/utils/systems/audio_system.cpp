@@ -2,12 +2,13 @@
 #include <SDL_mixer.h>
 #include <utils/logger.h>
 
-AudioSystem::AudioSystem(ResourceManager& resourceManager) : resourceManager(resourceManager), masterVolume(utils::GetConfig<float, "AudioSystem.masterVolume">())
+AudioSystem::AudioSystem(ResourceManager& resourceManager, Mode mode)
+  : resourceManager(resourceManager), masterVolume(utils::GetConfig<float, "AudioSystem.masterVolume">()), mode(mode)
 {}
 
 void AudioSystem::PlayMusic(const std::string& musicName)
 {
-    if (masterVolume == 0.0f)
+    if (mode == Mode::Disabled || masterVolume == 0.0f)
         return;
 
     auto musicRAII = resourceManager.GetMusic(musicName);
@@ -19,7 +20,7 @@ void AudioSystem::PlayMusic(const std::string& musicName)
 
 void AudioSystem::PlaySoundEffect(const std::string& soundEffectName)
 {
-    if (masterVolume == 0.0f)
+    if (mode == Mode::Disabled || masterVolume == 0.0f)
         return;
 
     const auto& soundEffectInfo = resourceManager.GetSoundEffect(soundEffectName);
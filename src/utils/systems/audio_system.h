@@ -4,10 +4,18 @@
 
 class AudioSystem
 {
+public:
+    enum class Mode
+    {
+        Enabled,
+        Disabled, // Neither loads nor plays sounds. Used in the headless mode where audio is not initialized.
+    };
+private:
     ResourceManager& resourceManager;
     const float& masterVolume;
+    Mode mode;
 public:
-    AudioSystem(ResourceManager& resourceManager);
+    AudioSystem(ResourceManager& resourceManager, Mode mode = Mode::Enabled);
     void PlayMusic(const std::string& musicName);
     void PlaySoundEffect(const std::string& soundEffectName);
 };
\ No newline at end of file
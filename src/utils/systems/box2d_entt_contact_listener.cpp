@@ -1,4 +1,7 @@
 #include "box2d_entt_contact_listener.h"
+#include <magic_enum.hpp>
+#include <stdexcept>
+#include <utility>
 #include <utils/logger.h>
 
 Box2dEnttContactListener::Box2dEnttContactListener(EnttRegistryWrapper& registryWrapper) : registryWrapper(registryWrapper), registry(registryWrapper)
@@ -6,50 +9,79 @@ Box2dEnttContactListener::Box2dEnttContactListener(EnttRegistryWrapper& registry
 
 void Box2dEnttContactListener::BeginContact(b2Contact* contact)
 {
-    if (auto validEntities = GetValidEntities(contact))
-    {
-        auto [entityWithPropsA, entityWithPropsB] = *validEntities;
+    RecordContact(contact, ContactType::Begin, ContactType::BeginSensor);
+}
 
-        for (auto& listener : contactListenersByType[ContactType::Begin])
-        {
-            if (!entityWithPropsA.isSensor && !entityWithPropsB.isSensor)
-            {
-                listener({entityWithPropsA.entity, entityWithPropsB.entity, contact});
-            }
-        }
+void Box2dEnttContactListener::EndContact(b2Contact* contact)
+{
+    RecordContact(contact, ContactType::End, ContactType::EndSensor);
+}
 
-        for (auto& listener : contactListenersByType[ContactType::BeginSensor])
-        {
-            if (entityWithPropsA.isSensor || entityWithPropsB.isSensor)
-            {
-                listener({entityWithPropsA.entity, entityWithPropsB.entity, contact});
-            }
-        }
+void Box2dEnttContactListener::RecordContact(b2Contact* contact, ContactType contactType, ContactType sensorContactType)
+{
+    bool isSensorContact = contact->GetFixtureA()->IsSensor() || contact->GetFixtureB()->IsSensor();
+    ContactType recordedContactType = isSensorContact ? sensorContactType : contactType;
+    if (routesByType[static_cast<size_t>(recordedContactType)].empty())
+        return;
+
+    auto validEntities = GetValidEntities(contact);
+    if (!validEntities)
+        return;
+
+    auto [entityWithPropsA, entityWithPropsB] = *validEntities;
+    uint32_t routesMask = MatchRoutes(recordedContactType, entityWithPropsA.entity, entityWithPropsB.entity);
+    if (routesMask == 0)
+        return;
+
+    ContactInfo contactInfo{entityWithPropsA.entity, entityWithPropsB.entity, entityWithPropsA.isSensor, entityWithPropsB.isSensor, std::nullopt};
+    if (contact->GetManifold()->pointCount > 0)
+    {
+        b2WorldManifold worldManifold;
+        contact->GetWorldManifold(&worldManifold);
+        contactInfo.pointPhysics = worldManifold.points[0];
     }
+    bufferedContacts.push_back({recordedContactType, routesMask, contactInfo});
+
+    // Contact outside the step (e.g. the body is destroyed). There is no step to wait for.
+    if (!isDispatching && !contact->GetFixtureA()->GetBody()->GetWorld()->IsLocked())
+        DispatchBufferedContacts();
 }
 
-void Box2dEnttContactListener::EndContact(b2Contact* contact)
+void Box2dEnttContactListener::DispatchBufferedContacts()
 {
-    if (auto validEntities = GetValidEntities(contact))
-    {
-        auto [entityWithPropsA, entityWithPropsB] = *validEntities;
+    if (isDispatching)
+        return;
 
-        for (auto& listener : contactListenersByType[ContactType::End])
-        {
-            if (!entityWithPropsA.isSensor && !entityWithPropsB.isSensor)
-            {
-                listener({entityWithPropsA.entity, entityWithPropsB.entity, contact});
-            }
-        }
+    isDispatching = true;
+    while (!bufferedContacts.empty())
+    {
+        // Listeners may destroy bodies. Contacts recorded by them are dispatched on the next iteration.
+        dispatchedContacts.clear();
+        std::swap(dispatchedContacts, bufferedContacts);
 
-        for (auto& listener : contactListenersByType[ContactType::EndSensor])
+        for (size_t typeIndex = 0; typeIndex < routesByType.size(); ++typeIndex)
         {
-            if (entityWithPropsA.isSensor || entityWithPropsB.isSensor)
+            const auto& routes = routesByType[typeIndex];
+            for (size_t routeIndex = 0; routeIndex < routes.size(); ++routeIndex)
             {
-                listener({entityWithPropsA.entity, entityWithPropsB.entity, contact});
+                uint32_t routeBit = 1u << routeIndex;
+                matchedContacts.clear();
+                for (const auto& [contactType, routesMask, contactInfo] : dispatchedContacts)
+                {
+                    if (static_cast<size_t>(contactType) != typeIndex || (routesMask & routeBit) == 0)
+                        continue;
+
+                    // Both entities may be destroyed by the previous listeners.
+                    if (registry.valid(contactInfo.entityA) || registry.valid(contactInfo.entityB))
+                        matchedContacts.push_back(contactInfo);
+                }
+
+                if (!matchedContacts.empty())
+                    routes[routeIndex].listener(matchedContacts);
             }
         }
     }
+    isDispatching = false;
 }
 
 std::optional<std::pair<Box2dEnttContactListener::EntityWithProperties, Box2dEnttContactListener::EntityWithProperties>> Box2dEnttContactListener::GetValidEntities(
@@ -92,7 +124,31 @@ std::optional<std::pair<Box2dEnttContactListener::EntityWithProperties, Box2dEnt
     return std::nullopt;
 }
 
+uint32_t Box2dEnttContactListener::MatchRoutes(ContactType contactType, entt::entity entityA, entt::entity entityB) const
+{
+    const auto& routes = routesByType[static_cast<size_t>(contactType)];
+    uint32_t routesMask = 0;
+    for (size_t routeIndex = 0; routeIndex < routes.size(); ++routeIndex)
+    {
+        auto isEntityMatched = routes[routeIndex].isEntityMatched;
+        if (!isEntityMatched || isEntityMatched(registry, entityA) || isEntityMatched(registry, entityB))
+            routesMask |= 1u << routeIndex;
+    }
+    return routesMask;
+}
+
 void Box2dEnttContactListener::SubscribeContact(ContactType contactType, ContactListener listener)
 {
-    contactListenersByType[contactType].push_back(listener);
+    AddRoute(contactType, {nullptr, std::move(listener)});
+}
+
+void Box2dEnttContactListener::AddRoute(ContactType contactType, ContactRoute route)
+{
+    auto& routes = routesByType[static_cast<size_t>(contactType)];
+    constexpr size_t maxRoutesPerType = sizeof(ContactRecord::routesMask) * 8;
+    if (routes.size() >= maxRoutesPerType)
+        throw std::runtime_error(MY_FMT("[Box2dEnttContactListener] Too many listeners of the contact type {}, max {}", magic_enum::enum_name(contactType),
+            maxRoutesPerType));
+
+    routes.push_back(std::move(route));
 }
@@ -1,8 +1,12 @@
 #pragma once
 #include "utils/entt/entt_registry_wrapper.h"
+#include <array>
 #include <box2d/box2d.h>
+#include <cstdint>
 #include <entt/entt.hpp>
+#include <functional>
 #include <optional>
+#include <span>
 #include <vector>
 
 class Box2dEnttContactListener : public b2ContactListener
@@ -12,21 +16,24 @@ public:
     {
         entt::entity entityA;
         entt::entity entityB;
-        b2Contact* contact;
+        bool isSensorA;
+        bool isSensorB;
+        std::optional<b2Vec2> pointPhysics; // First point of the world manifold. Empty for sensors and if there is no point.
     };
 
     /**
-     * IMPORTANT: ContactListener is called by Box2D during the simulation. It is not safe to modify the type of a Box2D
-     * body. Attempting to change the type of a b2Body (e.g., from dynamic to static or vice versa) while the Box2D
-     * world is locked (b2World::IsLocked() == true) is prohibited. The Box2D world is considered locked during the
-     * processing of physical simulations, such as collision detection and contact resolution. Changing a body's type
-     * under these conditions can lead to unpredictable behavior. Therefore, Box2D disallows type modifications to
-     * bodies while the world is in this locked state.
+     * Box2D calls BeginContact/EndContact during the simulation, when the world is locked (b2World::IsLocked() == true)
+     * and it is not allowed to create, destroy or change the type of bodies. So the contacts are only recorded during
+     * the step and ContactListener is called by DispatchBufferedContacts after the step has completed. Everything is
+     * allowed in the listener.
      *
-     * To safely change a body's type in reaction to collisions, consider deferring the change until after the
-     * physics simulation step has completed.
+     * Listener receives all matched contacts of the type recorded since the previous dispatch in one call. Contacts are
+     * matched when they are recorded, so unmatched contacts are never buffered. Entities of the contact were valid when
+     * the contact was recorded, but may be destroyed by the previous listeners. Check `registry.valid` before use.
+     *
+     * Contacts that happen outside the step (e.g. EndContact when a body is destroyed) are dispatched immediately.
      */
-    using ContactListener = std::function<void(const Box2dEnttContactListener::ContactInfo& contactInfo)>;
+    using ContactListener = std::function<void(std::span<const Box2dEnttContactListener::ContactInfo> contactInfos)>;
 
     enum class ContactType
     {
@@ -34,6 +41,7 @@ public:
         End,
         BeginSensor,
         EndSensor,
+        Count,
     };
 private:
     struct EntityWithProperties
@@ -42,9 +50,37 @@ private:
         bool isSensor;
         entt::entity entity;
     };
+
+    struct ContactRecord
+    {
+        ContactType contactType;
+        uint32_t routesMask; // Bit `i` is set if the route `i` of `contactType` matched the contact.
+        ContactInfo contactInfo;
+    };
+
+    // Listener with the filter of the entities. Filter is a plain function to keep the rejection of the contact cheap.
+    struct ContactRoute
+    {
+        bool (*isEntityMatched)(const entt::registry& registry, entt::entity entity); // nullptr - all contacts.
+        ContactListener listener;
+    };
 public:
     Box2dEnttContactListener(EnttRegistryWrapper& registryWrapper);
+    // Listener is called for all contacts of the type.
     void SubscribeContact(ContactType contactType, ContactListener listener);
+    // Listener is called only if at least one entity of the contact has all `ComponentTypes`.
+    // Tile-vs-tile contacts cost only the filter calls of the subscribed routes and are not buffered.
+    // At most 32 listeners of one contact type.
+    template <typename... ComponentTypes>
+    void SubscribeContact(ContactType contactType, ContactListener listener)
+    {
+        static_assert(sizeof...(ComponentTypes) > 0, "Use the non-template SubscribeContact to listen all contacts");
+        auto isEntityMatched = [](const entt::registry& registry, entt::entity entity) { return registry.all_of<ComponentTypes...>(entity); };
+        AddRoute(contactType, {isEntityMatched, std::move(listener)});
+    }
+    // Call the listeners with the contacts recorded during the step. Should be called after each b2World::Step.
+    // Contacts recorded by the listeners themselves (e.g. a body is destroyed) are dispatched in the same call.
+    void DispatchBufferedContacts();
 private:
     Box2dEnttContactListener(const Box2dEnttContactListener&) = delete;
     Box2dEnttContactListener& operator=(const Box2dEnttContactListener&) = delete;
@@ -53,9 +89,21 @@ private:
 private: ////////////// Interacting with Box2D. These methods are called by Box2D during the simulation. //////////////
     void BeginContact(b2Contact* contact) override;
     void EndContact(b2Contact* contact) override;
+    // Record the contact to the buffer if any route of `contactType` matches it. The matchers run before the world
+    // manifold is computed. Choose Begin/End or BeginSensor/EndSensor by the fixtures.
+    void RecordContact(b2Contact* contact, ContactType contactType, ContactType sensorContactType);
     std::optional<std::pair<EntityWithProperties, EntityWithProperties>> GetValidEntities(b2Contact* contact);
+    // Mask of the routes of `contactType` matched by one of the entities. Entities must be valid.
+    uint32_t MatchRoutes(ContactType contactType, entt::entity entityA, entt::entity entityB) const;
+private:
+    // Routes of one type are limited by the bits of `ContactRecord::routesMask`.
+    void AddRoute(ContactType contactType, ContactRoute route);
 private:
     EnttRegistryWrapper& registryWrapper;
     entt::registry& registry;
-    std::unordered_map<ContactType, std::vector<ContactListener>> contactListenersByType;
+    std::array<std::vector<ContactRoute>, static_cast<size_t>(ContactType::Count)> routesByType;
+    std::vector<ContactRecord> bufferedContacts; // Flat buffer of the contacts recorded since the previous dispatch.
+    std::vector<ContactRecord> dispatchedContacts; // Contacts of the current dispatch. Kept to reuse the memory.
+    std::vector<ContactInfo> matchedContacts; // Contacts passed to one listener. Kept to reuse the memory.
+    bool isDispatching = false;
 };
@@ -0,0 +1,95 @@
+#include "task_scheduler.h"
+
+TaskScheduler::TaskScheduler(size_t workersCount)
+{
+    workers.reserve(workersCount);
+    for (size_t i = 0; i < workersCount; ++i)
+        workers.emplace_back([this]() { WorkerLoop(); });
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard lock(mutex);
+        isStopping = true;
+    }
+    jobStarted.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void TaskScheduler::ParallelFor(size_t count, const std::function<void(size_t index)>& task)
+{
+    // Waking up the workers costs more than one task.
+    if (workers.empty() || count <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+            task(i);
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        this->task = &task;
+        tasksCount = count;
+        nextTaskIndex = 0;
+        firstException = nullptr;
+        activeWorkers = workers.size();
+        ++jobId;
+    }
+    jobStarted.notify_all();
+
+    RunTasks();
+
+    std::exception_ptr exception;
+    {
+        std::unique_lock lock(mutex);
+        jobFinished.wait(lock, [this]() { return activeWorkers == 0; });
+        this->task = nullptr;
+        exception = firstException;
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void TaskScheduler::WorkerLoop()
+{
+    uint64_t lastJobId = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock(mutex);
+            jobStarted.wait(lock, [this, lastJobId]() { return isStopping || jobId != lastJobId; });
+            if (isStopping)
+                return;
+            lastJobId = jobId;
+        }
+
+        RunTasks();
+
+        {
+            std::lock_guard lock(mutex);
+            if (--activeWorkers == 0)
+                jobFinished.notify_one();
+        }
+    }
+}
+
+void TaskScheduler::RunTasks()
+{
+    for (size_t index = nextTaskIndex++; index < tasksCount; index = nextTaskIndex++)
+    {
+        try
+        {
+            (*task)(index);
+        }
+        catch (...)
+        {
+            std::lock_guard lock(mutex);
+            if (!firstException)
+                firstException = std::current_exception();
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads for data parallel loops. The calling thread takes part in the work too.
+// With 0 workers everything runs on the calling thread, so the single-threaded path stays available.
+class TaskScheduler
+{
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable jobStarted;
+    std::condition_variable jobFinished;
+    bool isStopping = false;
+private: ///////////////////////////// Current job. Set under the mutex before the workers are woken up. ////////////////////////////
+    const std::function<void(size_t index)>* task = nullptr;
+    size_t tasksCount = 0;
+    std::atomic<size_t> nextTaskIndex = 0;
+    uint64_t jobId = 0; // Incremented for each job. Workers compare it with the last seen job.
+    size_t activeWorkers = 0; // Workers which have not finished the current job yet.
+    std::exception_ptr firstException;
+public:
+    explicit TaskScheduler(size_t workersCount);
+    ~TaskScheduler();
+    size_t GetWorkersCount() const { return workers.size(); }
+    // Call `task(index)` for every index in [0, count) and wait for all calls. Tasks must not touch Box2D or EnTT.
+    // The first exception thrown by the tasks is rethrown after all tasks are finished.
+    void ParallelFor(size_t count, const std::function<void(size_t index)>& task);
+private:
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+    TaskScheduler(TaskScheduler&&) = delete;
+    TaskScheduler& operator=(TaskScheduler&&) = delete;
+private:
+    void WorkerLoop();
+    // Take the tasks of the current job one by one until all of them are taken.
+    void RunTasks();
+};
@@ -0,0 +1,191 @@
+#include "terrain_contours.h"
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <utils/logger.h>
+
+namespace
+{
+
+// Point in the doubled sample coordinates. Sample (i, j) has key (2i, 2j). Middle of the edge has one odd coordinate.
+using PointKey = std::pair<int, int>;
+
+int Cross(const PointKey& a, const PointKey& b)
+{
+    return a.first * b.second - a.second * b.first;
+}
+
+PointKey Sub(const PointKey& a, const PointKey& b)
+{
+    return {a.first - b.first, a.second - b.second};
+}
+
+// Remove points which lay on the straight line between their neighbours.
+std::vector<PointKey> RemoveCollinearPoints(const std::vector<PointKey>& points, bool isLoop)
+{
+    if (points.size() < 3)
+        return points;
+
+    std::vector<PointKey> result;
+    const size_t count = points.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        bool isEndPoint = !isLoop && (i == 0 || i == count - 1);
+        if (!isEndPoint)
+        {
+            const auto& prev = points[(i + count - 1) % count];
+            const auto& next = points[(i + 1) % count];
+            if (Cross(Sub(points[i], prev), Sub(next, points[i])) == 0)
+                continue;
+        }
+        result.push_back(points[i]);
+    }
+
+    return result;
+}
+
+} // namespace
+
+namespace utils
+{
+
+std::vector<TerrainContour> ExtractChunkContours(const TerrainMask& mask, const SDL_Rect& chunkRect, int cellSize)
+{
+    if (cellSize <= 0 || chunkRect.x % cellSize != 0 || chunkRect.y % cellSize != 0)
+        throw std::runtime_error(MY_FMT("[ExtractChunkContours] Chunk {}x{} is not aligned to the cell size {}", chunkRect.x, chunkRect.y, cellSize));
+
+    const int cellsX = (mask.GetWidth() + cellSize - 1) / cellSize;
+    const int cellsY = (mask.GetHeight() + cellSize - 1) / cellSize;
+
+    // Squares are identified by their top left sample. Samples outside of the mask are empty, so the squares of the
+    // first chunks start from -1 to close the contours on the mask border.
+    const int squareBeginX = chunkRect.x == 0 ? -1 : chunkRect.x / cellSize;
+    const int squareBeginY = chunkRect.y == 0 ? -1 : chunkRect.y / cellSize;
+    const int squareEndX = std::min((chunkRect.x + chunkRect.w + cellSize - 1) / cellSize, cellsX); // Exclusive.
+    const int squareEndY = std::min((chunkRect.y + chunkRect.h + cellSize - 1) / cellSize, cellsY); // Exclusive.
+    if (squareBeginX >= squareEndX || squareBeginY >= squareEndY)
+        return {};
+
+    // Sample the mask. One extra sample on the right and bottom sides for the last squares.
+    const int samplesW = squareEndX - squareBeginX + 1;
+    const int samplesH = squareEndY - squareBeginY + 1;
+    std::vector<bool> samples(samplesW * samplesH, false);
+    for (int sj = 0; sj < samplesH; ++sj)
+    {
+        int j = squareBeginY + sj;
+        if (j < 0 || j >= cellsY)
+            continue;
+
+        for (int si = 0; si < samplesW; ++si)
+        {
+            int i = squareBeginX + si;
+            if (i < 0 || i >= cellsX)
+                continue;
+
+            SDL_Rect cellRect = mask.ClipRect({i * cellSize, j * cellSize, cellSize, cellSize});
+            samples[sj * samplesW + si] = mask.CountSolid(cellRect) * 2 >= cellRect.w * cellRect.h;
+        }
+    }
+    auto isSolid = [&](int i, int j) { return samples[(j - squareBeginY) * samplesW + (i - squareBeginX)]; };
+
+    // Marching squares. Corners and edges are enumerated clockwise from the top left corner and the top edge.
+    // Edge `k` connects corners `k` and `k + 1`.
+    std::map<PointKey, PointKey> nextPoint;
+    for (int j = squareBeginY; j < squareEndY; ++j)
+    {
+        for (int i = squareBeginX; i < squareEndX; ++i)
+        {
+            const bool corners[4] = {isSolid(i, j), isSolid(i + 1, j), isSolid(i + 1, j + 1), isSolid(i, j + 1)};
+            const PointKey cornerKeys[4] = {{2 * i, 2 * j}, {2 * i + 2, 2 * j}, {2 * i + 2, 2 * j + 2}, {2 * i, 2 * j + 2}};
+            const PointKey edgeKeys[4] = {{2 * i + 1, 2 * j}, {2 * i + 2, 2 * j + 1}, {2 * i + 1, 2 * j + 2}, {2 * i, 2 * j + 1}};
+
+            std::vector<int> crossedEdges;
+            for (int k = 0; k < 4; ++k)
+                if (corners[k] != corners[(k + 1) % 4])
+                    crossedEdges.push_back(k);
+
+            if (crossedEdges.empty())
+                continue;
+
+            std::vector<std::pair<int, int>> edgePairs;
+            if (crossedEdges.size() == 2)
+                edgePairs.push_back({crossedEdges[0], crossedEdges[1]});
+            else if (corners[0]) // Saddle. Solid corners are not connected: top left and bottom right are cut off.
+                edgePairs = {{0, 3}, {1, 2}};
+            else // Saddle. Top right and bottom left corners are cut off.
+                edgePairs = {{0, 1}, {2, 3}};
+
+            for (auto [edgeA, edgeB] : edgePairs)
+            {
+                // Choose the reference corner to orient the segment.
+                int referenceCorner = -1;
+                if ((edgeA + 1) % 4 == edgeB)
+                    referenceCorner = edgeB; // Adjacent edges. Shared corner is cut off.
+                else if ((edgeB + 1) % 4 == edgeA)
+                    referenceCorner = edgeA;
+                else
+                    for (int k = 0; k < 4; ++k) // Opposite edges. All solid corners are on the same side.
+                        if (corners[k])
+                            referenceCorner = k;
+
+                PointKey from = edgeKeys[edgeA];
+                PointKey to = edgeKeys[edgeB];
+                int side = Cross(Sub(to, from), Sub(cornerKeys[referenceCorner], from));
+                if ((side > 0) != corners[referenceCorner])
+                    std::swap(from, to);
+
+                nextPoint[from] = to;
+            }
+        }
+    }
+
+    // Link segments to polylines. Open polylines start in the points without incoming segments.
+    std::set<PointKey> pointsWithIncoming;
+    for (const auto& [from, to] : nextPoint)
+        pointsWithIncoming.insert(to);
+
+    std::vector<std::pair<std::vector<PointKey>, bool>> polylines;
+    auto followPolyline = [&nextPoint](PointKey start)
+    {
+        std::vector<PointKey> points{start};
+        for (auto it = nextPoint.find(start); it != nextPoint.end(); it = nextPoint.find(points.back()))
+        {
+            PointKey to = it->second;
+            nextPoint.erase(it);
+            if (to == start)
+                break;
+            points.push_back(to);
+        }
+        return points;
+    };
+
+    std::vector<PointKey> openStarts;
+    for (const auto& [from, to] : nextPoint)
+        if (!pointsWithIncoming.contains(from))
+            openStarts.push_back(from);
+
+    for (const auto& start : openStarts)
+        polylines.push_back({followPolyline(start), false});
+
+    while (!nextPoint.empty())
+        polylines.push_back({followPolyline(nextPoint.begin()->first), true});
+
+    // Convert to the pixel coordinates of the mask.
+    std::vector<TerrainContour> contours;
+    for (const auto& [points, isLoop] : polylines)
+    {
+        auto simplifiedPoints = RemoveCollinearPoints(points, isLoop);
+        if (simplifiedPoints.size() < (isLoop ? 3u : 2u))
+            continue;
+
+        TerrainContour contour;
+        contour.isLoop = isLoop;
+        for (const auto& [x, y] : simplifiedPoints)
+            contour.points.push_back(glm::vec2((x + 1) * cellSize / 2.0f, (y + 1) * cellSize / 2.0f));
+        contours.push_back(std::move(contour));
+    }
+
+    return contours;
+}
+
+} // namespace utils
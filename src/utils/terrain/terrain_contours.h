@@ -0,0 +1,25 @@
+#pragma once
+#include <SDL.h>
+#include <glm/glm.hpp>
+#include <utils/terrain/terrain_mask.h>
+#include <vector>
+
+// Polyline around the solid part of the mask. Coordinates are in pixels of the mask.
+// Points are ordered so the solid part is on the right side when looking along the polyline on the screen (Y-down).
+// So the collision normal of Box2D one-sided chain edges points to the empty space.
+struct TerrainContour
+{
+    std::vector<glm::vec2> points;
+    bool isLoop = false; // True if the contour is closed inside the chunk. Otherwise it ends on the chunk border.
+};
+
+namespace utils
+{
+
+// Extract contours of the solid part of the mask inside the chunk with marching squares.
+// Mask is sampled in the centers of the cells of `cellSize`. Cell is solid if at least half of its pixels are solid.
+// Contours of neighbour chunks do not overlap, they are connected in the points on the chunk borders.
+// `chunkRect` must be aligned to the `cellSize` grid.
+std::vector<TerrainContour> ExtractChunkContours(const TerrainMask& mask, const SDL_Rect& chunkRect, int cellSize);
+
+} // namespace utils
@@ -0,0 +1,177 @@
+#include "terrain_mask.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utils/logger.h>
+#include <utils/sdl/sdl_alpha_kernels.h>
+#include <utils/sdl/sdl_RAII.h>
+
+namespace
+{
+
+constexpr Uint32 alphaMaskABGR8888 = 0xFF000000;
+
+} // namespace
+
+TerrainMask::TerrainMask(int width, int height) : width(width), height(height), pixels(static_cast<size_t>(width) * height, 0)
+{
+    if (width <= 0 || height <= 0)
+        throw std::runtime_error(MY_FMT("[TerrainMask] Invalid mask size: {}x{}", width, height));
+}
+
+bool TerrainMask::IsSolid(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= width || y >= height)
+        return false;
+
+    return (pixels[y * width + x] & alphaMaskABGR8888) != 0;
+}
+
+SDL_Rect TerrainMask::ClipRect(const SDL_Rect& rect) const
+{
+    SDL_Rect maskRect = GetRect();
+    SDL_Rect clippedRect;
+    if (!SDL_IntersectRect(&maskRect, &rect, &clippedRect))
+        return {0, 0, 0, 0};
+
+    return clippedRect;
+}
+
+bool TerrainMask::IsAnySolid(const SDL_Rect& rect) const
+{
+    SDL_Rect clippedRect = ClipRect(rect);
+
+    for (int y = clippedRect.y; y < clippedRect.y + clippedRect.h; ++y)
+        if (utils::AnyAlpha(&pixels[y * width + clippedRect.x], clippedRect.w, alphaMaskABGR8888))
+            return true;
+
+    return false;
+}
+
+int TerrainMask::CountSolid(const SDL_Rect& rect) const
+{
+    SDL_Rect clippedRect = ClipRect(rect);
+
+    int count = 0;
+    for (int y = clippedRect.y; y < clippedRect.y + clippedRect.h; ++y)
+        count += utils::CountAlpha(&pixels[y * width + clippedRect.x], clippedRect.w, alphaMaskABGR8888);
+
+    return count;
+}
+
+void TerrainMask::CopyFromSurface(SDL_Surface* surface, const SDL_Rect& srcRect, const SDL_Point& dstPoint)
+{
+    CopyPixelsFromSurface(surface, srcRect, dstPoint, false);
+}
+
+SDL_Rect TerrainMask::StampFromSurface(SDL_Surface* surface, const SDL_Rect& srcRect, const SDL_Point& dstPoint)
+{
+    return CopyPixelsFromSurface(surface, srcRect, dstPoint, true);
+}
+
+SDL_Rect TerrainMask::CopyPixelsFromSurface(SDL_Surface* surface, const SDL_Rect& srcRect, const SDL_Point& dstPoint, bool skipEmptyPixels)
+{
+    if (!surface)
+        throw std::runtime_error("[TerrainMask::CopyPixelsFromSurface] Surface is NULL");
+
+    if (surface->format->format != SDL_PIXELFORMAT_ABGR8888)
+        throw std::runtime_error(MY_FMT(
+            "[TerrainMask::CopyPixelsFromSurface] Unsupported surface format: {}", SDL_GetPixelFormatName(surface->format->format)));
+
+    SDLSurfaceLockRAII lock(surface);
+    const Uint32* surfacePixels = static_cast<const Uint32*>(surface->pixels);
+    int surfacePitch = surface->pitch / 4; // pitch is in bytes, so divide by 4 to get the number of pixels.
+
+    SDL_Point changedMin{width, height};
+    SDL_Point changedMax{-1, -1}; // Inclusive.
+    for (int row = 0; row < srcRect.h; ++row)
+    {
+        int dstY = dstPoint.y + row;
+        int srcY = srcRect.y + row;
+        if (dstY < 0 || dstY >= height || srcY < 0 || srcY >= surface->h)
+            continue;
+
+        for (int col = 0; col < srcRect.w; ++col)
+        {
+            int dstX = dstPoint.x + col;
+            int srcX = srcRect.x + col;
+            if (dstX < 0 || dstX >= width || srcX < 0 || srcX >= surface->w)
+                continue;
+
+            Uint32 pixel = surfacePixels[srcY * surfacePitch + srcX];
+            if (skipEmptyPixels && !(pixel & alphaMaskABGR8888))
+                continue;
+
+            pixels[dstY * width + dstX] = pixel;
+            changedMin = {std::min(changedMin.x, dstX), std::min(changedMin.y, dstY)};
+            changedMax = {std::max(changedMax.x, dstX), std::max(changedMax.y, dstY)};
+        }
+    }
+
+    if (changedMax.x < 0)
+        return {0, 0, 0, 0};
+
+    return {changedMin.x, changedMin.y, changedMax.x - changedMin.x + 1, changedMax.y - changedMin.y + 1};
+}
+
+SDL_Rect TerrainMask::CarveCircle(const glm::vec2& centerPixels, float radiusPixels)
+{
+    SDL_Rect boundingRect = {
+        static_cast<int>(std::floor(centerPixels.x - radiusPixels)), static_cast<int>(std::floor(centerPixels.y - radiusPixels)), 0, 0};
+    boundingRect.w = static_cast<int>(std::ceil(centerPixels.x + radiusPixels)) - boundingRect.x + 1;
+    boundingRect.h = static_cast<int>(std::ceil(centerPixels.y + radiusPixels)) - boundingRect.y + 1;
+    SDL_Rect clippedRect = ClipRect(boundingRect);
+
+    int minX = std::numeric_limits<int>::max();
+    int minY = std::numeric_limits<int>::max();
+    int maxX = std::numeric_limits<int>::min();
+    int maxY = std::numeric_limits<int>::min();
+
+    const float radiusSquared = radiusPixels * radiusPixels;
+    for (int y = clippedRect.y; y < clippedRect.y + clippedRect.h; ++y)
+    {
+        float dy = static_cast<float>(y) + 0.5f - centerPixels.y;
+        for (int x = clippedRect.x; x < clippedRect.x + clippedRect.w; ++x)
+        {
+            float dx = static_cast<float>(x) + 0.5f - centerPixels.x;
+            if (dx * dx + dy * dy > radiusSquared)
+                continue;
+
+            Uint32& pixel = pixels[y * width + x];
+            if ((pixel & alphaMaskABGR8888) == 0)
+                continue;
+
+            pixel = 0;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+        }
+    }
+
+    if (minX == std::numeric_limits<int>::max())
+    {
+        // No pixels were changed.
+        return {0, 0, 0, 0};
+    }
+
+    return {minX, minY, maxX - minX + 1, maxY - minY + 1};
+}
+
+namespace utils
+{
+
+SDL_Rect UniteRects(const SDL_Rect& a, const SDL_Rect& b)
+{
+    if (a.w <= 0 || a.h <= 0)
+        return b;
+    if (b.w <= 0 || b.h <= 0)
+        return a;
+
+    SDL_Rect result;
+    SDL_UnionRect(&a, &b, &result);
+    return result;
+}
+
+} // namespace utils
@@ -0,0 +1,52 @@
+#pragma once
+#include <SDL.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+// Destructible terrain stored as a per-pixel image. Alpha channel of the pixel is used as the occupancy mask.
+// Pixel format is SDL_PIXELFORMAT_ABGR8888 (the same as surfaces loaded with streaming access).
+// Coordinates are in pixels of the mask. Pixel (0, 0) is the top left pixel.
+class TerrainMask
+{
+    int width = 0;
+    int height = 0;
+    std::vector<Uint32> pixels; // Row-major pixels. Pixel is solid if its alpha is not zero.
+public:
+    TerrainMask() = default;
+    TerrainMask(int width, int height);
+public: /////////////////////////////////////////////// Accessors. ///////////////////////////////////////////////
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    int GetPitch() const { return width * static_cast<int>(sizeof(Uint32)); } // Number of bytes in a row.
+    const Uint32* GetPixels() const { return pixels.data(); }
+    Uint32 GetPixel(int x, int y) const { return pixels[y * width + x]; }
+    void SetPixel(int x, int y, Uint32 pixel) { pixels[y * width + x] = pixel; }
+    SDL_Rect GetRect() const { return {0, 0, width, height}; }
+public: ////////////////////////////////////////////// Occupancy. ///////////////////////////////////////////////
+    // Return false for pixels outside of the mask.
+    bool IsSolid(int x, int y) const;
+    // Check if there is at least one solid pixel inside the rect. Rect is clipped by the mask.
+    bool IsAnySolid(const SDL_Rect& rect) const;
+    // Count solid pixels inside the rect. Rect is clipped by the mask.
+    int CountSolid(const SDL_Rect& rect) const;
+    // Clip the rect by the mask. Return empty rect if there is no intersection.
+    SDL_Rect ClipRect(const SDL_Rect& rect) const;
+public: ///////////////////////////////////////////// Modification. //////////////////////////////////////////////
+    // Copy the rect of the ABGR8888 surface to the mask. Pixels outside of the mask are skipped.
+    void CopyFromSurface(SDL_Surface* surface, const SDL_Rect& srcRect, const SDL_Point& dstPoint);
+    // Same as CopyFromSurface, but empty pixels of the surface do not overwrite the mask.
+    // Return the rect of changed pixels (empty if nothing changed).
+    SDL_Rect StampFromSurface(SDL_Surface* surface, const SDL_Rect& srcRect, const SDL_Point& dstPoint);
+    // Clear all solid pixels whose centers are inside the circle. Return the rect of changed pixels (empty if nothing changed).
+    SDL_Rect CarveCircle(const glm::vec2& centerPixels, float radiusPixels);
+private:
+    SDL_Rect CopyPixelsFromSurface(SDL_Surface* surface, const SDL_Rect& srcRect, const SDL_Point& dstPoint, bool skipEmptyPixels);
+};
+
+namespace utils
+{
+
+// Return the smallest rect containing both rects. Empty rects are ignored.
+SDL_Rect UniteRects(const SDL_Rect& a, const SDL_Rect& b);
+
+} // namespace utils
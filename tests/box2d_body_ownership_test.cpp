@@ -0,0 +1,97 @@
+// Invariants of the registry ownership of Box2D bodies: a body of PhysicsComponent is returned to
+// GameOptions::bodyPool or destroyed exactly once, when the component or its entity is removed.
+#include "test_utils.h"
+#include <box2d/box2d.h>
+#include <ecs/components/physics_components.h>
+#include <entt/entt.hpp>
+#include <utils/box2d/box2d_body_ownership.h>
+#include <utils/game_options.h>
+#include <vector>
+
+namespace
+{
+
+using test_utils::Check;
+
+entt::entity SpawnBody(entt::registry& registry, Box2dBodyOptions::Shape shape)
+{
+    auto& gameState = registry.get<GameOptions>(registry.view<GameOptions>().front());
+
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_dynamicBody;
+    b2Body* body = gameState.physicsWorld->CreateBody(&bodyDef);
+    b2PolygonShape box;
+    box.SetAsBox(0.5f, 0.5f);
+    body->CreateFixture(&box, 1.0f);
+
+    PhysicsComponent physicsComponent;
+    physicsComponent.body = body;
+    physicsComponent.options.shape = shape;
+    physicsComponent.options.hitbox.sizeWorld = {10.0f, 10.0f};
+
+    auto entity = registry.create();
+    registry.emplace<PhysicsComponent>(entity, physicsComponent);
+    return entity;
+}
+
+void TestReleaseToPool()
+{
+    entt::registry registry;
+    utils::ConnectBox2dBodyOwnership(registry);
+    auto& gameState = registry.emplace<GameOptions>(registry.create());
+    gameState.physicsWorld = std::make_shared<b2World>(gameState.gravity);
+    gameState.bodyPool = std::make_shared<Box2dBodyPool>(gameState.physicsWorld);
+
+    // Copies of the component don't own the body.
+    auto entity = SpawnBody(registry, Box2dBodyOptions::Shape::Box);
+    b2Body* body = registry.get<PhysicsComponent>(entity).body;
+    {
+        [[maybe_unused]] PhysicsComponent copy = registry.get<PhysicsComponent>(entity);
+    }
+    Check(body->IsEnabled() && gameState.bodyPool->GetPooledBodiesCount() == 0, "Copy of the component doesn't release the body");
+
+    registry.destroy(entity);
+    Check(gameState.bodyPool->GetPooledBodiesCount() == 1, "Body of the destroyed entity is pooled");
+    Check(!body->IsEnabled(), "Pooled body is disabled");
+    Check(gameState.physicsWorld->GetBodyCount() == 1, "Pooled body stays in the world");
+
+    auto reusedEntity = SpawnBody(registry, Box2dBodyOptions::Shape::Box);
+    registry.remove<PhysicsComponent>(reusedEntity);
+    Check(registry.valid(reusedEntity), "Entity stays alive after the component is removed");
+    Check(gameState.bodyPool->GetPooledBodiesCount() == 2, "Body of the removed component is pooled");
+
+    // Bodies with the fixtures of the owner can't be reused. They are destroyed.
+    auto terrainEntity = SpawnBody(registry, Box2dBodyOptions::Shape::None);
+    registry.destroy(terrainEntity);
+    Check(gameState.physicsWorld->GetBodyCount() == 2, "Body without the pool key is destroyed");
+
+    gameState.bodyPool.reset();
+    Check(gameState.physicsWorld->GetBodyCount() == 0, "Pooled bodies are destroyed with the pool");
+}
+
+void TestDestroyWithoutPool()
+{
+    entt::registry registry;
+    utils::ConnectBox2dBodyOwnership(registry);
+    auto& gameState = registry.emplace<GameOptions>(registry.create());
+    gameState.physicsWorld = std::make_shared<b2World>(gameState.gravity);
+
+    for (int i = 0; i < 3; ++i)
+        SpawnBody(registry, Box2dBodyOptions::Shape::Box);
+    registry.emplace<PhysicsComponent>(registry.create()); // Component without the body.
+
+    auto physicsView = registry.view<PhysicsComponent>();
+    std::vector<entt::entity> physicsEntities(physicsView.begin(), physicsView.end());
+    registry.destroy(physicsEntities.begin(), physicsEntities.end());
+    Check(gameState.physicsWorld->GetBodyCount() == 0, "Bodies are destroyed in the world if there is no pool");
+}
+
+} // namespace
+
+int main()
+{
+    test_utils::InitConfig("box2d_body_ownership_test", R"({ "Box2dBodyPool": { "maxBodiesPerKey": 10 } })");
+    TestReleaseToPool();
+    TestDestroyWithoutPool();
+    return test_utils::Finish();
+}
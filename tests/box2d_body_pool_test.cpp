@@ -0,0 +1,92 @@
+// Invariants of Box2dBodyPool: bodies go back to the pool disabled, are handed out by the key only,
+// the pool doesn't grow over `Box2dBodyPool.maxBodiesPerKey` and destroys the pooled bodies with itself.
+#include "test_utils.h"
+#include <box2d/box2d.h>
+#include <utils/box2d/box2d_body_pool.h>
+
+namespace
+{
+
+constexpr size_t maxBodiesPerKey = 2;
+
+using test_utils::Check;
+
+b2Body* CreateBoxBody(b2World& world)
+{
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_dynamicBody;
+    b2Body* body = world.CreateBody(&bodyDef);
+    b2PolygonShape box;
+    box.SetAsBox(0.5f, 0.5f);
+    body->CreateFixture(&box, 1.0f);
+    return body;
+}
+
+Box2dBodyOptions MakeOptions(Box2dBodyOptions::Shape shape, float sizeWorld)
+{
+    Box2dBodyOptions options;
+    options.shape = shape;
+    options.hitbox.sizeWorld = {sizeWorld, sizeWorld};
+    return options;
+}
+
+void TestKeys()
+{
+    Check(!Box2dBodyPool::MakeKey(MakeOptions(Box2dBodyOptions::Shape::None, 10.0f)), "Bodies without the tuner fixtures have no key");
+
+    auto boxKey = Box2dBodyPool::MakeKey(MakeOptions(Box2dBodyOptions::Shape::Box, 10.0f));
+    auto sameBoxKey = Box2dBodyPool::MakeKey(MakeOptions(Box2dBodyOptions::Shape::Box, 10.0f));
+    auto biggerBoxKey = Box2dBodyPool::MakeKey(MakeOptions(Box2dBodyOptions::Shape::Box, 20.0f));
+    auto circleKey = Box2dBodyPool::MakeKey(MakeOptions(Box2dBodyOptions::Shape::Circle, 10.0f));
+    Check(boxKey && sameBoxKey && biggerBoxKey && circleKey, "Bodies with the tuner fixtures have a key");
+    Check(!(*boxKey < *sameBoxKey) && !(*sameBoxKey < *boxKey), "Same options give equal keys");
+    Check((*boxKey < *biggerBoxKey) != (*biggerBoxKey < *boxKey), "Hitbox size is a part of the key");
+    Check((*boxKey < *circleKey) != (*circleKey < *boxKey), "Shape is a part of the key");
+}
+
+void TestAcquireRelease()
+{
+    auto world = std::make_shared<b2World>(b2Vec2(0.0f, 10.0f));
+    auto boxKey = *Box2dBodyPool::MakeKey(MakeOptions(Box2dBodyOptions::Shape::Box, 10.0f));
+    auto circleKey = *Box2dBodyPool::MakeKey(MakeOptions(Box2dBodyOptions::Shape::Circle, 10.0f));
+
+    {
+        Box2dBodyPool pool(world);
+        Check(pool.Acquire(boxKey) == nullptr, "Empty pool returns nullptr");
+        Check(pool.GetStats().misses == 1, "Acquire from the empty pool is a miss");
+
+        b2Body* body = CreateBoxBody(*world);
+        pool.Release(boxKey, body);
+        Check(!body->IsEnabled(), "Released body is disabled");
+        Check(body->GetFixtureList() != nullptr, "Released body keeps the fixtures");
+        Check(pool.GetPooledBodiesCount() == 1 && pool.GetStats().released == 1, "Released body is counted as pooled");
+
+        Check(pool.Acquire(circleKey) == nullptr, "Body is not handed out for another key");
+        Check(pool.Acquire(boxKey) == body, "Body is handed out for its key");
+        Check(pool.GetPooledBodiesCount() == 0 && pool.GetStats().hits == 1, "Acquired body is not pooled anymore");
+        Check(pool.Acquire(boxKey) == nullptr, "Body is handed out once");
+
+        // Over the limit the bodies are destroyed instead of being pooled.
+        for (size_t i = 0; i < maxBodiesPerKey + 1; ++i)
+            pool.Release(boxKey, CreateBoxBody(*world));
+        pool.Release(boxKey, body);
+        Check(pool.GetPooledBodiesCount() == maxBodiesPerKey, "Pool doesn't grow over maxBodiesPerKey");
+        Check(pool.GetStats().dropped == 2, "Bodies over maxBodiesPerKey are dropped");
+        Check(static_cast<size_t>(world->GetBodyCount()) == maxBodiesPerKey, "Dropped bodies are destroyed");
+
+        const auto& stats = pool.GetStats();
+        Check(stats.released + stats.dropped == 1 + maxBodiesPerKey + 2, "Every returned body is either released or dropped");
+    }
+
+    Check(world->GetBodyCount() == 0, "Pooled bodies are destroyed with the pool");
+}
+
+} // namespace
+
+int main()
+{
+    test_utils::InitConfig("box2d_body_pool_test", R"({ "Box2dBodyPool": { "maxBodiesPerKey": )" + std::to_string(maxBodiesPerKey) + " } }");
+    TestKeys();
+    TestAcquireRelease();
+    return test_utils::Finish();
+}
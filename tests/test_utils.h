@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <my_cpp_utils/config.h>
+#include <string>
+
+// Minimal harness of the tests. A failed check is reported and the test goes on, so one run shows all failures.
+namespace test_utils
+{
+
+inline int failedChecks = 0;
+
+inline void Check(bool condition, const char* description)
+{
+    if (condition)
+        return;
+
+    std::cerr << "FAILED: " << description << std::endl;
+    ++failedChecks;
+}
+
+// Init the config from `configJson`. The config is read from a file, so the JSON is written to a temp file of the test.
+inline void InitConfig(const std::string& testName, const std::string& configJson)
+{
+    auto configFilePath = std::filesystem::temp_directory_path() / (testName + "_config.json");
+    std::ofstream configFile(configFilePath);
+    configFile << configJson;
+    configFile.close();
+    utils::Config::InitInstanceFromFile(configFilePath);
+}
+
+// Report the result of the checks. Return the exit code of the test.
+inline int Finish()
+{
+    if (failedChecks != 0)
+    {
+        std::cerr << failedChecks << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "All checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+} // namespace test_utils